@@ -0,0 +1,141 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "AI/ChaosAIScheduler.h"
+#include "AI/ChaosEnemyTickManager.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Components/StateTreeComponent.h"
+#include "Engine/World.h"
+
+DECLARE_STATS_GROUP(TEXT("ChaosAI"), STATGROUP_ChaosAI, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Brains"), STAT_ChaosAI_Evaluate, STATGROUP_ChaosAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Brains Evaluated"), STAT_ChaosAI_NumEvaluated, STATGROUP_ChaosAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backlog"), STAT_ChaosAI_Backlog, STATGROUP_ChaosAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Brains"), STAT_ChaosAI_NumBrains, STATGROUP_ChaosAI);
+
+void UChaosAIScheduler::RegisterBrain(AChaosEnemy* Enemy, UStateTreeComponent* Brain)
+{
+	if (!IsValid(Enemy) || !IsValid(Brain) || Entries.ContainsByPredicate([Enemy](const FEntry& Entry) { return Entry.Enemy.Get() == Enemy; }))
+	{
+		return;
+	}
+
+	// The scheduler ticks the brain from now on.
+	Brain->SetComponentTickEnabled(false);
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Enemy = Enemy;
+	Entry.Brain = Brain;
+	Entry.LastEvaluationTime = GetWorld()->GetTimeSeconds();
+	INC_DWORD_STAT(STAT_ChaosAI_NumBrains);
+}
+
+void UChaosAIScheduler::UnregisterBrain(AChaosEnemy* Enemy)
+{
+	const int32 EntryIndex = Entries.IndexOfByPredicate([Enemy](const FEntry& Entry) { return Entry.Enemy.Get() == Enemy; });
+	if (EntryIndex != INDEX_NONE)
+	{
+		Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+		DEC_DWORD_STAT(STAT_ChaosAI_NumBrains);
+	}
+}
+
+void UChaosAIScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_ChaosAI_Evaluate);
+
+	// Drop brains whose enemy is gone before scheduling, so the passes below never see stale entries.
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		if (!Entries[EntryIndex].Enemy.IsValid() || !Entries[EntryIndex].Brain.IsValid())
+		{
+			Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+			DEC_DWORD_STAT(STAT_ChaosAI_NumBrains);
+		}
+	}
+
+	const int32 NumEntries = Entries.Num();
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double StartSeconds = FPlatformTime::Seconds();
+	const double EndSeconds = StartSeconds + BudgetMs * 0.001;
+	const UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>();
+
+	EvaluatedThisFrame.Init(false, NumEntries);
+	int32 NumEvaluated = 0;
+	int32 NumActive = 0;
+
+	// Priority pass: enemies the player is fighting right now never wait.
+	for (int32 EntryIndex = 0; EntryIndex < NumEntries; ++EntryIndex)
+	{
+		const EChaosEnemyTickBucket Bucket = TickManager ? TickManager->GetEnemyBucket(Entries[EntryIndex].Enemy.Get()) : EChaosEnemyTickBucket::Reduced;
+		if (Bucket == EChaosEnemyTickBucket::Dormant)
+		{
+			// Dormant enemies are not evaluated at all; mark them so the round-robin pass skips them too. Their clock
+			// keeps running, so waking up does not hand the brain all the time it spent asleep as a single step.
+			EvaluatedThisFrame[EntryIndex] = true;
+			Entries[EntryIndex].LastEvaluationTime = Now;
+			continue;
+		}
+
+		++NumActive;
+		if (Bucket == EChaosEnemyTickBucket::Full)
+		{
+			Evaluate(Entries[EntryIndex], Now);
+			EvaluatedThisFrame[EntryIndex] = true;
+			++NumEvaluated;
+		}
+	}
+
+	// Round-robin pass: continue where the last frame stopped until the budget is used up.
+	for (int32 Step = 0; Step < NumEntries && FPlatformTime::Seconds() < EndSeconds; ++Step)
+	{
+		RoundRobinCursor = RoundRobinCursor < NumEntries ? RoundRobinCursor : 0;
+		const int32 EntryIndex = RoundRobinCursor++;
+		if (!EvaluatedThisFrame[EntryIndex])
+		{
+			Evaluate(Entries[EntryIndex], Now);
+			EvaluatedThisFrame[EntryIndex] = true;
+			++NumEvaluated;
+		}
+	}
+
+	LastFrameStats.NumEvaluated = NumEvaluated;
+	LastFrameStats.Backlog = NumActive - NumEvaluated;
+	LastFrameStats.UsedMs = static_cast<float>((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+	SET_DWORD_STAT(STAT_ChaosAI_NumEvaluated, LastFrameStats.NumEvaluated);
+	SET_DWORD_STAT(STAT_ChaosAI_Backlog, LastFrameStats.Backlog);
+}
+
+TStatId UChaosAIScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosAIScheduler, STATGROUP_Tickables);
+}
+
+bool UChaosAIScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosAIScheduler::Evaluate(FEntry& Entry, double Now)
+{
+	UStateTreeComponent* Brain = Entry.Brain.Get();
+	const float ElapsedTime = static_cast<float>(Now - Entry.LastEvaluationTime);
+	Entry.LastEvaluationTime = Now;
+
+	// Starting or restarting the tree (e.g. when the enemy comes back from the pool) may turn the brain's own tick back on.
+	if (Brain->IsComponentTickEnabled())
+	{
+		Brain->SetComponentTickEnabled(false);
+	}
+
+	if (Brain->IsRunning())
+	{
+		Brain->TickComponent(ElapsedTime, LEVELTICK_All, nullptr);
+
+		// The tree may schedule its own tick while it runs; it must not tick natively in the same frame as well.
+		if (Brain->IsComponentTickEnabled())
+		{
+			Brain->SetComponentTickEnabled(false);
+		}
+	}
+}
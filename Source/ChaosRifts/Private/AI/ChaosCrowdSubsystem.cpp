@@ -0,0 +1,250 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "AI/ChaosCrowdSubsystem.h"
+#include "AI/ChaosEnemyPoolSubsystem.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/ChaosAttributes.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+namespace ChaosCrowd
+{
+	// How far above and below a record's location the ground is searched for when it is promoted.
+	static constexpr float GroundTraceUp = 500.f;
+	static constexpr float GroundTraceDown = 2000.f;
+
+	/** Collects the locations of all player pawns. */
+	static void GatherPlayerLocations(const UWorld* World, TArray<FVector, TInlineAllocator<4>>& OutLocations)
+	{
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr)
+			{
+				OutLocations.Add(Pawn->GetActorLocation());
+			}
+		}
+	}
+}
+
+void UChaosCrowdSubsystem::SpawnCrowdEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location)
+{
+	if (!EnemyClass)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	ChaosCrowd::GatherPlayerLocations(GetWorld(), PlayerLocations);
+
+	if (!PlayerLocations.IsEmpty() && GetClosestDistanceSquared(Location, PlayerLocations) <= FMath::Square(PromoteRadius))
+	{
+		if (AChaosEnemy* Enemy = PromoteToActor(EnemyClass, Location, FVector::ZeroVector, 1.f))
+		{
+			PromotedEnemies.Add(Enemy);
+		}
+		return;
+	}
+
+	AddRecord(EnemyClass, Location, FVector::ZeroVector, 1.f);
+}
+
+void UChaosCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Distances are measured from the closest player pawn.
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	ChaosCrowd::GatherPlayerLocations(GetWorld(), PlayerLocations);
+
+	if (PlayerLocations.IsEmpty())
+	{
+		return;
+	}
+
+	SimulateRecords(DeltaTime, PlayerLocations);
+	DemoteEnemies(PlayerLocations);
+	PromoteRecords(PlayerLocations);
+}
+
+TStatId UChaosCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosCrowdSubsystem, STATGROUP_Tickables);
+}
+
+bool UChaosCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosCrowdSubsystem::AddRecord(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location, const FVector& Velocity, float HealthFraction)
+{
+	const AChaosEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AChaosEnemy>();
+	const UCharacterMovementComponent* MovementDefaults = EnemyDefaults->GetCharacterMovement();
+
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	Speeds.Add(MovementDefaults ? MovementDefaults->MaxWalkSpeed : 0.f);
+	HealthFractions.Add(HealthFraction);
+	States.Add(ERecordState::Idle);
+	Classes.Add(EnemyClass);
+}
+
+void UChaosCrowdSubsystem::RemoveRecord(int32 RecordIndex)
+{
+	Locations.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+	Speeds.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+	HealthFractions.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+	States.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+	Classes.RemoveAtSwap(RecordIndex, 1, EAllowShrinking::No);
+}
+
+void UChaosCrowdSubsystem::SimulateRecords(float DeltaTime, TConstArrayView<FVector> PlayerLocations)
+{
+	const int32 NumRecords = Locations.Num();
+	const double AggroRadiusSquared = FMath::Square(static_cast<double>(AggroRadius));
+
+	FVector* RESTRICT RecordLocations = Locations.GetData();
+	FVector* RESTRICT RecordVelocities = Velocities.GetData();
+	const float* RESTRICT RecordSpeeds = Speeds.GetData();
+	ERecordState* RESTRICT RecordStates = States.GetData();
+
+	// Records walk straight towards the closest player on the horizontal plane. They do not collide with the level;
+	// the ground is found again when they are promoted.
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		int32 PlayerIndex = 0;
+		const double DistanceSquared = GetClosestDistanceSquared(RecordLocations[Index], PlayerLocations, &PlayerIndex);
+		const bool bChasing = DistanceSquared <= AggroRadiusSquared;
+
+		const FVector ToPlayer = (PlayerLocations[PlayerIndex] - RecordLocations[Index]) * FVector(1.0, 1.0, 0.0);
+		RecordVelocities[Index] = bChasing ? ToPlayer.GetSafeNormal() * RecordSpeeds[Index] : FVector::ZeroVector;
+		RecordLocations[Index] += RecordVelocities[Index] * DeltaTime;
+		RecordStates[Index] = bChasing ? ERecordState::Chasing : ERecordState::Idle;
+	}
+}
+
+void UChaosCrowdSubsystem::PromoteRecords(TConstArrayView<FVector> PlayerLocations)
+{
+	const double PromoteRadiusSquared = FMath::Square(static_cast<double>(PromoteRadius));
+	int32 NumPromoted = 0;
+
+	// Iterate backwards so promoted records can be swap-removed in place.
+	for (int32 Index = Locations.Num() - 1; Index >= 0 && NumPromoted < MaxPromotionsPerFrame; --Index)
+	{
+		if (GetClosestDistanceSquared(Locations[Index], PlayerLocations) > PromoteRadiusSquared)
+		{
+			continue;
+		}
+
+		// Failed attempts count against the budget as well. The record stays in the crowd and is tried again on a
+		// later pass, e.g. once the pool has an enemy to spare.
+		++NumPromoted;
+		if (AChaosEnemy* Enemy = PromoteToActor(Classes[Index], Locations[Index], Velocities[Index], HealthFractions[Index]))
+		{
+			PromotedEnemies.Add(Enemy);
+			RemoveRecord(Index);
+		}
+	}
+}
+
+void UChaosCrowdSubsystem::DemoteEnemies(TConstArrayView<FVector> PlayerLocations)
+{
+	const double DemoteRadiusSquared = FMath::Square(static_cast<double>(DemoteRadius));
+	UChaosEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UChaosEnemyPoolSubsystem>();
+	int32 NumDemoted = 0;
+
+	for (int32 Index = PromotedEnemies.Num() - 1; Index >= 0; --Index)
+	{
+		AChaosEnemy* Enemy = PromotedEnemies[Index].Get();
+		const UChaosAttributes* Attributes = Enemy ? Enemy->GetAttributes() : nullptr;
+
+		// Dead enemies are no longer part of the crowd; they go to the pool on their own.
+		if (!Attributes || Enemy->IsPooled() || Attributes->GetHealth() <= 0.f)
+		{
+			PromotedEnemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (NumDemoted >= MaxDemotionsPerFrame || GetClosestDistanceSquared(Enemy->GetActorLocation(), PlayerLocations) <= DemoteRadiusSquared)
+		{
+			continue;
+		}
+
+		const FVector FeetLocation = Enemy->GetActorLocation() - FVector(0.f, 0.f, Enemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+		AddRecord(Enemy->GetClass(), FeetLocation, Enemy->GetVelocity(), Attributes->GetHealth() / Attributes->GetMaxHealth());
+
+		if (EnemyPool)
+		{
+			EnemyPool->ReleaseEnemy(Enemy);
+		}
+		else
+		{
+			Enemy->Destroy();
+		}
+		PromotedEnemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		++NumDemoted;
+	}
+}
+
+AChaosEnemy* UChaosCrowdSubsystem::PromoteToActor(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location, const FVector& Velocity, float HealthFraction)
+{
+	UWorld* World = GetWorld();
+	const AChaosEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AChaosEnemy>();
+	const float HalfHeight = EnemyDefaults->GetCapsuleComponent() ? EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 0.f;
+
+	// Records move without collision, so put the actor back onto the ground below (or above) the record.
+	FVector GroundLocation = Location;
+	FHitResult GroundHit;
+	if (World->LineTraceSingleByObjectType(GroundHit, Location + FVector(0.f, 0.f, ChaosCrowd::GroundTraceUp), Location - FVector(0.f, 0.f, ChaosCrowd::GroundTraceDown), FCollisionObjectQueryParams(ECC_WorldStatic)))
+	{
+		GroundLocation = GroundHit.ImpactPoint;
+	}
+
+	const FTransform SpawnTransform(Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation(), GroundLocation + FVector(0.f, 0.f, HalfHeight));
+
+	AChaosEnemy* Enemy = nullptr;
+	if (UChaosEnemyPoolSubsystem* EnemyPool = World->GetSubsystem<UChaosEnemyPoolSubsystem>())
+	{
+		Enemy = EnemyPool->AcquireEnemy(EnemyClass, SpawnTransform);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		Enemy = World->SpawnActor<AChaosEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+	}
+
+	if (!Enemy)
+	{
+		return nullptr;
+	}
+
+	// Carry over the damage the enemy took before it was demoted.
+	if (UChaosAttributes* Attributes = Enemy->GetAttributes(); Attributes && HealthFraction < 1.f)
+	{
+		Attributes->ApplyHealthChange(-(1.f - HealthFraction) * Attributes->GetMaxHealth());
+	}
+	Enemy->GetCharacterMovement()->Velocity = Velocity;
+	return Enemy;
+}
+
+double UChaosCrowdSubsystem::GetClosestDistanceSquared(const FVector& Location, TConstArrayView<FVector> PlayerLocations, int32* OutPlayerIndex)
+{
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerLocations.Num(); ++PlayerIndex)
+	{
+		const double DistanceSquared = FVector::DistSquared(Location, PlayerLocations[PlayerIndex]);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			if (OutPlayerIndex)
+			{
+				*OutPlayerIndex = PlayerIndex;
+			}
+		}
+	}
+	return ClosestDistanceSquared;
+}
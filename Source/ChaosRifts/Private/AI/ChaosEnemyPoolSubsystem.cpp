@@ -0,0 +1,75 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "AI/ChaosEnemyPoolSubsystem.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Engine/World.h"
+
+AChaosEnemy* UChaosEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	if (!EnemyClass)
+	{
+		return nullptr;
+	}
+
+	if (FChaosEnemyPoolList* Pool = Pools.Find(EnemyClass.Get()))
+	{
+		while (!Pool->Enemies.IsEmpty())
+		{
+			AChaosEnemy* Enemy = Pool->Enemies.Pop(EAllowShrinking::No);
+			if (IsValid(Enemy))
+			{
+				Enemy->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+				Enemy->ReactivateFromPool();
+				return Enemy;
+			}
+		}
+	}
+
+	return SpawnEnemy(EnemyClass, SpawnTransform);
+}
+
+void UChaosEnemyPoolSubsystem::ReleaseEnemy(AChaosEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsPooled())
+	{
+		return;
+	}
+
+	Enemy->DeactivateForPool();
+	Pools.FindOrAdd(Enemy->GetClass()).Enemies.Add(Enemy);
+}
+
+void UChaosEnemyPoolSubsystem::Prewarm(TSubclassOf<AChaosEnemy> EnemyClass, int32 Count)
+{
+	if (!EnemyClass)
+	{
+		return;
+	}
+
+	const int32 NumToSpawn = Count - GetNumPooledEnemies(EnemyClass);
+	for (int32 Index = 0; Index < NumToSpawn; ++Index)
+	{
+		if (AChaosEnemy* Enemy = SpawnEnemy(EnemyClass, FTransform::Identity))
+		{
+			ReleaseEnemy(Enemy);
+		}
+	}
+}
+
+int32 UChaosEnemyPoolSubsystem::GetNumPooledEnemies(TSubclassOf<AChaosEnemy> EnemyClass) const
+{
+	const FChaosEnemyPoolList* Pool = Pools.Find(EnemyClass.Get());
+	return Pool ? Pool->Enemies.Num() : 0;
+}
+
+bool UChaosEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AChaosEnemy* UChaosEnemyPoolSubsystem::SpawnEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FTransform& SpawnTransform) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	return GetWorld()->SpawnActor<AChaosEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+}
@@ -0,0 +1,182 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "AI/ChaosEnemyTickManager.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UChaosEnemyTickManager::UChaosEnemyTickManager()
+{
+	auto InitBucket = [this](EChaosEnemyTickBucket Bucket, float MaxDistance, float TickInterval)
+	{
+		BucketSettings[static_cast<int32>(Bucket)].MaxDistance = MaxDistance;
+		BucketSettings[static_cast<int32>(Bucket)].TickInterval = TickInterval;
+	};
+
+	// Defaults only, the buckets are meant to be tuned per project in DefaultGame.ini.
+	InitBucket(EChaosEnemyTickBucket::Full, 2000.f, 0.f);
+	InitBucket(EChaosEnemyTickBucket::Reduced, 4500.f, 1.f / 20.f);
+	InitBucket(EChaosEnemyTickBucket::Low, 9000.f, 1.f / 5.f);
+}
+
+void UChaosEnemyTickManager::RegisterEnemy(AChaosEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || EntryIndices.Contains(Enemy))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = Entries.AddDefaulted();
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Enemy = Enemy;
+	Entry.Key = Enemy;
+	Entry.Bucket = EChaosEnemyTickBucket::Full;
+	EntryIndices.Add(Enemy, EntryIndex);
+	++BucketCounts[static_cast<int32>(EChaosEnemyTickBucket::Full)];
+}
+
+void UChaosEnemyTickManager::UnregisterEnemy(AChaosEnemy* Enemy)
+{
+	if (const int32* EntryIndex = EntryIndices.Find(Enemy))
+	{
+		if (IsValid(Enemy))
+		{
+			ApplyBucket(Enemy, EChaosEnemyTickBucket::Full);
+		}
+		RemoveEntry(*EntryIndex);
+	}
+}
+
+EChaosEnemyTickBucket UChaosEnemyTickManager::GetEnemyBucket(const AChaosEnemy* Enemy) const
+{
+	const int32* EntryIndex = EntryIndices.Find(Enemy);
+	return EntryIndex ? Entries[*EntryIndex].Bucket : EChaosEnemyTickBucket::Full;
+}
+
+int32 UChaosEnemyTickManager::GetNumEnemiesInBucket(EChaosEnemyTickBucket Bucket) const
+{
+	return Bucket < EChaosEnemyTickBucket::Num ? BucketCounts[static_cast<int32>(Bucket)] : 0;
+}
+
+void UChaosEnemyTickManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeUntilEvaluation -= DeltaTime;
+	if (TimeUntilEvaluation <= 0.f)
+	{
+		TimeUntilEvaluation = EvaluationInterval;
+		EvaluateBuckets();
+	}
+}
+
+TStatId UChaosEnemyTickManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosEnemyTickManager, STATGROUP_Tickables);
+}
+
+bool UChaosEnemyTickManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosEnemyTickManager::EvaluateBuckets()
+{
+	// Significance is measured from the closest local player pawn.
+	TArray<FVector, TInlineAllocator<4>> ViewerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr)
+		{
+			ViewerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	// Without a player there is nothing to be significant to; keep everyone at their current rate.
+	if (ViewerLocations.IsEmpty())
+	{
+		return;
+	}
+
+	// Iterate backwards so stale entries can be swap-removed in place.
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		AChaosEnemy* Enemy = Entries[EntryIndex].Enemy.Get();
+		if (!Enemy)
+		{
+			RemoveEntry(EntryIndex);
+			continue;
+		}
+
+		const FVector EnemyLocation = Enemy->GetActorLocation();
+		float DistanceSquared = TNumericLimits<float>::Max();
+		for (const FVector& ViewerLocation : ViewerLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, static_cast<float>(FVector::DistSquared(EnemyLocation, ViewerLocation)));
+		}
+
+		float Distance = FMath::Sqrt(DistanceSquared);
+		if (!Enemy->WasRecentlyRendered(VisibilityTolerance))
+		{
+			Distance *= OffscreenDistanceScale;
+		}
+
+		const EChaosEnemyTickBucket NewBucket = GetBucketForDistance(Distance);
+		FEntry& Entry = Entries[EntryIndex];
+		if (NewBucket != Entry.Bucket)
+		{
+			--BucketCounts[static_cast<int32>(Entry.Bucket)];
+			++BucketCounts[static_cast<int32>(NewBucket)];
+			Entry.Bucket = NewBucket;
+			ApplyBucket(Enemy, NewBucket);
+		}
+	}
+}
+
+EChaosEnemyTickBucket UChaosEnemyTickManager::GetBucketForDistance(float Distance) const
+{
+	for (int32 BucketIndex = 0; BucketIndex < static_cast<int32>(EChaosEnemyTickBucket::Dormant); ++BucketIndex)
+	{
+		if (Distance <= BucketSettings[BucketIndex].MaxDistance)
+		{
+			return static_cast<EChaosEnemyTickBucket>(BucketIndex);
+		}
+	}
+	return EChaosEnemyTickBucket::Dormant;
+}
+
+void UChaosEnemyTickManager::ApplyBucket(AChaosEnemy* Enemy, EChaosEnemyTickBucket Bucket) const
+{
+	const bool bDormant = Bucket == EChaosEnemyTickBucket::Dormant;
+	const float TickInterval = bDormant ? 0.f : BucketSettings[static_cast<int32>(Bucket)].TickInterval;
+
+	Enemy->SetActorTickInterval(TickInterval);
+	Enemy->SetTickBlocked(EChaosTickBlock::Dormant, bDormant);
+
+	if (UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(TickInterval);
+		Movement->SetComponentTickEnabled(!bDormant);
+	}
+
+	if (USkeletalMeshComponent* Mesh = Enemy->GetMesh())
+	{
+		Mesh->SetComponentTickInterval(TickInterval);
+		Mesh->SetComponentTickEnabled(!bDormant);
+	}
+}
+
+void UChaosEnemyTickManager::RemoveEntry(int32 EntryIndex)
+{
+	--BucketCounts[static_cast<int32>(Entries[EntryIndex].Bucket)];
+	EntryIndices.Remove(Entries[EntryIndex].Key);
+
+	Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+	if (Entries.IsValidIndex(EntryIndex))
+	{
+		// The last entry was moved into the freed slot.
+		EntryIndices.Add(Entries[EntryIndex].Key, EntryIndex);
+	}
+}
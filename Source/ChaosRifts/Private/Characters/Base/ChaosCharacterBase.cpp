@@ -6,10 +6,18 @@
 #include "Components/CapsuleComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Items/Weapons/Weapon.h"
+#include "Items/Weapons/ChaosWeaponComponent.h"
+#include "Combat/ChaosTargetIndexSubsystem.h"
+#include "Combat/ChaosRagdollBudgetSubsystem.h"
+#include "Core/ChaosCooldownSubsystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
 
 AChaosCharacterBase::AChaosCharacterBase()
 {
 	PrimaryActorTick.bCanEverTick = false;
+	// Ticking characters switch their tick on per state, see SetTickState.
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	AttributesComponent = CreateDefaultSubobject<UChaosAttributes>(TEXT("AttributesComponent"));
 	CurrentWeaponIndex = -1; // -1 means no weapon is equipped
 }
@@ -17,14 +25,48 @@ AChaosCharacterBase::AChaosCharacterBase()
 void AChaosCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Blueprint tick logic cannot announce when it is needed, so it keeps the actor ticking.
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick)))
+	{
+		SetTickState(EChaosTickState::Blueprint, true);
+	}
+	UpdateActorTick();
+
+	// Remember the collision setup, death changes it and pooled characters need it back.
+	DefaultCapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
+	DefaultMeshCollision = GetMesh()->GetCollisionEnabled();
+
+	// Health can run out through damage as well as through effects applied by the attribute store (e.g. poison).
+	if (AttributesComponent)
+	{
+		AttributesComponent->OnHealthDepleted.AddDynamic(this, &AChaosCharacterBase::HandleHealthDepleted);
+	}
+
 	// We call the weapon spawning here so that every inheriting character
 	// automatically gets their weapons.
 	SpawnAndEquipWeapons();
+
+	// Make this character findable by combat queries.
+	if (UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>())
+	{
+		TargetIndex->RegisterCharacter(this);
+	}
+}
+
+void AChaosCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>())
+	{
+		TargetIndex->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AChaosCharacterBase::SpawnAndEquipWeapons()
 {
-	// Destroy old weapon actors if this function is called again
+	// Destroy old weapon actors (or components) if this function is called again
 	for (AWeapon* Weapon : Weapons)
 	{
 		if (Weapon)
@@ -32,36 +74,62 @@ void AChaosCharacterBase::SpawnAndEquipWeapons()
 			Weapon->Destroy();
 		}
 	}
+	for (UChaosWeaponComponent* WeaponComponent : WeaponComponents)
+	{
+		if (WeaponComponent)
+		{
+			WeaponComponent->DestroyComponent();
+		}
+	}
 	Weapons.Empty();
+	WeaponComponents.Empty();
 	CurrentWeapon = nullptr;
     CurrentWeaponIndex = -1;
 
 	// Proceed if we have a valid loadout configured
 	if (DefaultWeaponLoadout.Num() > 0)
 	{
+		// Resolve where each weapon attaches once, so equips and swaps do not search the components.
+		BuildWeaponAttachTargets();
+
 		FActorSpawnParameters SpawnParams;
 		SpawnParams.Owner = this;
 		SpawnParams.Instigator = this;
 
 		// Iterate through the loadout configuration
-		for (const FWeaponLoadoutInfo& LoadoutInfo : DefaultWeaponLoadout)
+		for (int32 LoadoutIndex = 0; LoadoutIndex < DefaultWeaponLoadout.Num(); ++LoadoutIndex)
 		{
-			if (LoadoutInfo.WeaponClass)
+			const FWeaponLoadoutInfo& LoadoutInfo = DefaultWeaponLoadout[LoadoutIndex];
+			if (!LoadoutInfo.WeaponClass)
+			{
+				continue;
+			}
+
+			if (bUseWeaponComponents)
+			{
+				// Create the weapon as a component of this character, configured like the weapon class.
+				UChaosWeaponComponent* NewWeaponComponent = NewObject<UChaosWeaponComponent>(this);
+				NewWeaponComponent->InitializeFromWeaponClass(LoadoutInfo.WeaponClass);
+				NewWeaponComponent->SetHiddenInGame(true); // Hide the weapon initially
+				NewWeaponComponent->RegisterComponent();
+				WeaponComponents.Add(NewWeaponComponent);
+				AttachWeapon(NewWeaponComponent, LoadoutIndex, false);
+				continue;
+			}
+
+			// Spawn the weapon
+			AWeapon* NewWeapon = GetWorld()->SpawnActor<AWeapon>(LoadoutInfo.WeaponClass, SpawnParams);
+			if (NewWeapon)
 			{
-				// Spawn the weapon
-				AWeapon* NewWeapon = GetWorld()->SpawnActor<AWeapon>(LoadoutInfo.WeaponClass, SpawnParams);
-				if (NewWeapon)
-				{
-					// Add the new weapon instance to our runtime array
-					Weapons.Add(NewWeapon);
-					// Attach the weapon to its designated "sheathed" or "holstered" socket
-					AttachWeaponToSocket(NewWeapon, LoadoutInfo.SheathedSocketName);
-					NewWeapon->SetActorHiddenInGame(true); // Hide the weapon initially
-				}
+				// Add the new weapon instance to our runtime array
+				Weapons.Add(NewWeapon);
+				// Attach the weapon to its designated "sheathed" or "holstered" socket
+				AttachWeapon(NewWeapon->GetRootComponent(), LoadoutIndex, false);
+				NewWeapon->SetActorHiddenInGame(true); // Hide the weapon initially
 			}
 		}
 
-		if (Weapons.Num() > 0)
+		if (GetNumWeapons() > 0)
 		{
 			// Equip the first weapon in the loadout by default
 			EquipWeapon(0);
@@ -72,64 +140,91 @@ void AChaosCharacterBase::SpawnAndEquipWeapons()
 void AChaosCharacterBase::EquipWeapon(int32 WeaponIndex)
 {
 	// Check for valid index and that the weapon instance exists
-	if (!Weapons.IsValidIndex(WeaponIndex) || Weapons[WeaponIndex] == nullptr)
+	USceneComponent* NewWeaponRoot = GetWeaponRoot(WeaponIndex);
+	if (!NewWeaponRoot)
 	{
 		return;
 	}
 
 	// --- UNEQUIP OLD WEAPON ---
 	// If we already have a weapon equipped...
-	if (CurrentWeapon && DefaultWeaponLoadout.IsValidIndex(CurrentWeaponIndex))
+	if (USceneComponent* OldWeaponRoot = GetWeaponRoot(CurrentWeaponIndex); OldWeaponRoot && DefaultWeaponLoadout.IsValidIndex(CurrentWeaponIndex))
 	{
-		// Get the loadout info for the CURRENTLY equipped weapon
-		const FWeaponLoadoutInfo& OldWeaponLoadout = DefaultWeaponLoadout[CurrentWeaponIndex];
-		// Attach it back to its sheathed position
-		AttachWeaponToSocket(CurrentWeapon, OldWeaponLoadout.SheathedSocketName);
+		// Attach the CURRENTLY equipped weapon back to its sheathed position
+		AttachWeapon(OldWeaponRoot, CurrentWeaponIndex, false);
 		// Hide it
-		CurrentWeapon->SetActorHiddenInGame(true);
+		SetWeaponHidden(CurrentWeaponIndex, true);
 	}
 
 	// --- EQUIP NEW WEAPON ---
-	// Get the new weapon and its loadout info
-	AWeapon* NewWeaponToEquip = Weapons[WeaponIndex];
-	const FWeaponLoadoutInfo& NewWeaponLoadout = DefaultWeaponLoadout[WeaponIndex];
-
 	// Update our state
-	CurrentWeapon = NewWeaponToEquip;
+	CurrentWeapon = bUseWeaponComponents ? nullptr : Weapons[WeaponIndex];
 	CurrentWeaponIndex = WeaponIndex;
 
 	// Attach the new weapon to the hand/equipped socket
-	AttachWeaponToSocket(CurrentWeapon, NewWeaponLoadout.EquippedSocketName);
+	AttachWeapon(NewWeaponRoot, WeaponIndex, true);
 	// Make it visible
-	CurrentWeapon->SetActorHiddenInGame(false);
+	SetWeaponHidden(WeaponIndex, false);
+}
+
+int32 AChaosCharacterBase::GetNumWeapons() const
+{
+	return bUseWeaponComponents ? WeaponComponents.Num() : Weapons.Num();
+}
+
+USceneComponent* AChaosCharacterBase::GetWeaponRoot(int32 WeaponIndex) const
+{
+	if (bUseWeaponComponents)
+	{
+		return WeaponComponents.IsValidIndex(WeaponIndex) ? WeaponComponents[WeaponIndex].Get() : nullptr;
+	}
+	return Weapons.IsValidIndex(WeaponIndex) && Weapons[WeaponIndex] ? Weapons[WeaponIndex]->GetRootComponent() : nullptr;
+}
+
+void AChaosCharacterBase::SetWeaponHidden(int32 WeaponIndex, bool bHidden)
+{
+	if (bUseWeaponComponents)
+	{
+		if (WeaponComponents.IsValidIndex(WeaponIndex) && WeaponComponents[WeaponIndex])
+		{
+			WeaponComponents[WeaponIndex]->SetHiddenInGame(bHidden);
+		}
+	}
+	else if (Weapons.IsValidIndex(WeaponIndex) && Weapons[WeaponIndex])
+	{
+		Weapons[WeaponIndex]->SetActorHiddenInGame(bHidden);
+	}
 }
 
-void AChaosCharacterBase::AttachWeaponToSocket(AWeapon* WeaponToAttach, const FName& SocketName)
+void AChaosCharacterBase::AttachWeapon(USceneComponent* WeaponToAttach, int32 LoadoutIndex, bool bEquipped)
 {
-	if (!WeaponToAttach || SocketName.IsNone())
+	if (!WeaponToAttach || !DefaultWeaponLoadout.IsValidIndex(LoadoutIndex))
 	{
 		return;
 	}
 
-	// Attachment rules - we want the weapon to be welded to the socket, ignoring its own transform.
-	const FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, EAttachmentRule::SnapToTarget, EAttachmentRule::KeepWorld, false);
+	if (!WeaponAttachTargets.IsValidIndex(LoadoutIndex))
+	{
+		BuildWeaponAttachTargets();
+	}
 
-	// --- Smart Socket/Component Search ---
-	// First, check if a USceneComponent with the given name exists on this character.
-	TArray<USceneComponent*> SceneComponents;
-	GetComponents<USceneComponent>(SceneComponents);
-	USceneComponent* TargetComponent = nullptr;
+	const FWeaponAttachTarget* Target = &(bEquipped ? WeaponAttachTargets[LoadoutIndex].Equipped : WeaponAttachTargets[LoadoutIndex].Sheathed);
+	if (Target->Component.IsStale())
+	{
+		// The component was destroyed since the targets were resolved.
+		BuildWeaponAttachTargets();
+		Target = &(bEquipped ? WeaponAttachTargets[LoadoutIndex].Equipped : WeaponAttachTargets[LoadoutIndex].Sheathed);
+	}
 
-	for (USceneComponent* SceneComp : SceneComponents)
+	if (!Target->Component.IsValid() && Target->SocketName.IsNone())
 	{
-		if (SceneComp->GetFName() == SocketName)
-		{
-			TargetComponent = SceneComp;
-			break;
-		}
+		return;
 	}
 
-	if (TargetComponent)
+	// Attachment rules - we want the weapon to be welded to the socket, ignoring its own transform.
+	const FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, EAttachmentRule::SnapToTarget, EAttachmentRule::KeepWorld, false);
+
+	if (USceneComponent* TargetComponent = Target->Component.Get())
 	{
 		// We found a dedicated Scene Component, attach to it.
 		WeaponToAttach->AttachToComponent(TargetComponent, AttachmentRules);
@@ -137,10 +232,40 @@ void AChaosCharacterBase::AttachWeaponToSocket(AWeapon* WeaponToAttach, const FN
 	else
 	{
 		// Fallback: If no Scene Component was found, attach to a socket on the main skeletal mesh.
-		WeaponToAttach->AttachToComponent(GetMesh(), AttachmentRules, SocketName);
+		WeaponToAttach->AttachToComponent(GetMesh(), AttachmentRules, Target->SocketName);
 	}
 }
 
+void AChaosCharacterBase::BuildWeaponAttachTargets()
+{
+	// --- Smart Socket/Component Search ---
+	// One pass over the components serves every socket name of the loadout.
+	TMap<FName, USceneComponent*> ComponentsByName;
+	ForEachComponent<USceneComponent>(false, [&ComponentsByName](USceneComponent* SceneComp)
+	{
+		ComponentsByName.FindOrAdd(SceneComp->GetFName(), SceneComp);
+	});
+
+	auto Resolve = [&ComponentsByName](const FName& SocketName)
+	{
+		FWeaponAttachTarget Target;
+		if (!SocketName.IsNone())
+		{
+			USceneComponent* const* Component = ComponentsByName.Find(SocketName);
+			Target.Component = Component ? *Component : nullptr;
+			Target.SocketName = Component ? NAME_None : SocketName;
+		}
+		return Target;
+	};
+
+	WeaponAttachTargets.Reset(DefaultWeaponLoadout.Num());
+	for (const FWeaponLoadoutInfo& LoadoutInfo : DefaultWeaponLoadout)
+	{
+		FWeaponAttachTargets& Targets = WeaponAttachTargets.AddDefaulted_GetRef();
+		Targets.Sheathed = Resolve(LoadoutInfo.SheathedSocketName);
+		Targets.Equipped = Resolve(LoadoutInfo.EquippedSocketName);
+	}
+}
 
 void AChaosCharacterBase::StartAttack()
 {
@@ -150,20 +275,69 @@ void AChaosCharacterBase::StartAttack()
 	}
 }
 
+bool AChaosCharacterBase::IsCooldownReady(FName CooldownId) const
+{
+	const UChaosCooldownSubsystem* Cooldowns = GetWorld()->GetSubsystem<UChaosCooldownSubsystem>();
+	return !Cooldowns || Cooldowns->IsCooldownReady(this, CooldownId);
+}
+
+void AChaosCharacterBase::StartCooldown(FName CooldownId, float Duration, FSimpleDelegate OnExpired)
+{
+	if (UChaosCooldownSubsystem* Cooldowns = GetWorld()->GetSubsystem<UChaosCooldownSubsystem>())
+	{
+		Cooldowns->StartCooldown(this, CooldownId, Duration, MoveTemp(OnExpired));
+	}
+}
+
+void AChaosCharacterBase::CancelCooldown(FName CooldownId)
+{
+	if (UChaosCooldownSubsystem* Cooldowns = GetWorld()->GetSubsystem<UChaosCooldownSubsystem>())
+	{
+		Cooldowns->CancelCooldown(this, CooldownId);
+	}
+}
+
+void AChaosCharacterBase::SetTickState(EChaosTickState State, bool bActive)
+{
+	const EChaosTickState OldStates = TickStates;
+	bActive ? EnumAddFlags(TickStates, State) : EnumRemoveFlags(TickStates, State);
+	if (TickStates != OldStates)
+	{
+		UpdateActorTick();
+	}
+}
+
+void AChaosCharacterBase::SetTickBlocked(EChaosTickBlock Block, bool bBlocked)
+{
+	const EChaosTickBlock OldBlocks = TickBlocks;
+	bBlocked ? EnumAddFlags(TickBlocks, Block) : EnumRemoveFlags(TickBlocks, Block);
+	if (TickBlocks != OldBlocks)
+	{
+		UpdateActorTick();
+	}
+}
+
+void AChaosCharacterBase::UpdateActorTick()
+{
+	SetActorTickEnabled(TickStates != EChaosTickState::None && TickBlocks == EChaosTickBlock::None);
+}
+
 void AChaosCharacterBase::SwapToNextWeapon()
 {
-	if (Weapons.Num() > 1)
+	const int32 NumWeapons = GetNumWeapons();
+	if (NumWeapons > 1)
 	{
-		const int32 NextWeaponIndex = (CurrentWeaponIndex + 1) % Weapons.Num();
+		const int32 NextWeaponIndex = (CurrentWeaponIndex + 1) % NumWeapons;
 		EquipWeapon(NextWeaponIndex);
 	}
 }
 
 void AChaosCharacterBase::SwapToPreviousWeapon()
 {
-	if (Weapons.Num() > 1)
+	const int32 NumWeapons = GetNumWeapons();
+	if (NumWeapons > 1)
 	{
-		const int32 PrevWeaponIndex = (CurrentWeaponIndex - 1 + Weapons.Num()) % Weapons.Num();
+		const int32 PrevWeaponIndex = (CurrentWeaponIndex - 1 + NumWeapons) % NumWeapons;
 		EquipWeapon(PrevWeaponIndex);
 	}
 }
@@ -173,21 +347,27 @@ AWeapon* AChaosCharacterBase::GetCurrentWeapon() const
 	return CurrentWeapon;
 }
 
+UChaosWeaponComponent* AChaosCharacterBase::GetCurrentWeaponComponent() const
+{
+	return bUseWeaponComponents && WeaponComponents.IsValidIndex(CurrentWeaponIndex) ? WeaponComponents[CurrentWeaponIndex].Get() : nullptr;
+}
+
 
 float AChaosCharacterBase::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	const float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 	if (!AttributesComponent) return 0.0f;
 	
+	// If this depletes Health, HandleHealthDepleted kills the character.
 	AttributesComponent->ApplyHealthChange(-ActualDamage);
-
-	if (AttributesComponent->GetHealth() <= 0.0f)
-	{
-		Die();
-	}
 	return ActualDamage;
 }
 
+void AChaosCharacterBase::HandleHealthDepleted(UChaosAttributes* DepletedAttributes)
+{
+	Die();
+}
+
 void AChaosCharacterBase::Die_Implementation()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Character '%s' has died!"), *GetNameSafe(this));
@@ -201,7 +381,154 @@ void AChaosCharacterBase::Die_Implementation()
 		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
 	GetMesh()->SetCollisionEnabled(ECollisionEnabled::PhysicsOnly);
-	GetMesh()->SetSimulatePhysics(true);
+
+	// Ragdolls share a global budget; corpses beyond it are frozen in their death pose instead.
+	if (UChaosRagdollBudgetSubsystem* RagdollBudget = GetWorld()->GetSubsystem<UChaosRagdollBudgetSubsystem>())
+	{
+		RagdollBudget->RequestRagdoll(this);
+	}
+	else
+	{
+		GetMesh()->SetSimulatePhysics(true);
+	}
+
+	// Dead characters are no longer valid targets.
+	if (UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>())
+	{
+		TargetIndex->UnregisterCharacter(this);
+	}
 
 	OnDeath.Broadcast(this);
 }
+
+bool AChaosCharacterBase::IsDead() const
+{
+	return AttributesComponent && AttributesComponent->GetHealth() <= 0.f;
+}
+
+void AChaosCharacterBase::DeactivateForPool()
+{
+	bIsPooled = true;
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (UChaosCooldownSubsystem* Cooldowns = GetWorld()->GetSubsystem<UChaosCooldownSubsystem>())
+	{
+		Cooldowns->CancelAllCooldowns(this);
+	}
+
+	if (UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>())
+	{
+		TargetIndex->UnregisterCharacter(this);
+	}
+
+	if (const AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->StopLogic(TEXT("Pooled"));
+		}
+	}
+
+	if (UChaosRagdollBudgetSubsystem* RagdollBudget = GetWorld()->GetSubsystem<UChaosRagdollBudgetSubsystem>())
+	{
+		RagdollBudget->CancelRagdoll(this);
+	}
+
+	ResetMeshPhysics();
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	for (AWeapon* Weapon : Weapons)
+	{
+		if (Weapon)
+		{
+			Weapon->SetWeaponState(EWeaponState::Passive);
+			Weapon->SetActorHiddenInGame(true);
+			Weapon->SetActorEnableCollision(false);
+		}
+	}
+	// Weapon components belong to the character, so they lose their collision together with it below.
+	for (UChaosWeaponComponent* WeaponComponent : WeaponComponents)
+	{
+		if (WeaponComponent)
+		{
+			WeaponComponent->SetWeaponState(EWeaponState::Passive);
+			WeaponComponent->SetHiddenInGame(true);
+		}
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetTickBlocked(EChaosTickBlock::Pooled, true);
+}
+
+void AChaosCharacterBase::ReactivateFromPool()
+{
+	bIsPooled = false;
+
+	SetActorEnableCollision(true);
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultCapsuleCollision);
+	GetMesh()->SetCollisionEnabled(DefaultMeshCollision);
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	if (AttributesComponent)
+	{
+		AttributesComponent->ResetAttributes();
+	}
+
+	// Re-equip the first weapon, like a freshly spawned character does.
+	for (AWeapon* Weapon : Weapons)
+	{
+		if (Weapon)
+		{
+			Weapon->SetActorEnableCollision(true);
+		}
+	}
+	EquipWeapon(0);
+
+	SetActorHiddenInGame(false);
+	SetTickBlocked(EChaosTickBlock::Pooled, false);
+
+	if (UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>())
+	{
+		TargetIndex->RegisterCharacter(this);
+	}
+
+	if (const AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->RestartLogic();
+		}
+	}
+
+	OnReactivatedFromPool();
+}
+
+void AChaosCharacterBase::ResetMeshPhysics()
+{
+	USkeletalMeshComponent* MeshComponent = GetMesh();
+
+	// Undo the pose freezing of the ragdoll budget, including the death pose of corpses that never ragdolled.
+	MeshComponent->bNoSkeletonUpdate = false;
+	MeshComponent->bPauseAnims = false;
+	if (MeshComponent->GetAnimationMode() == EAnimationMode::AnimationSingleNode && DeathPose)
+	{
+		MeshComponent->SetAnimationMode(EAnimationMode::AnimationBlueprint);
+	}
+	MeshComponent->SetRelativeRotation(GetBaseRotationOffset());
+
+	if (!MeshComponent->IsSimulatingPhysics() && MeshComponent->GetAttachParent() == GetCapsuleComponent())
+	{
+		return;
+	}
+
+	// Simulating physics detaches the mesh from the capsule, so put it back where the character expects it.
+	MeshComponent->SetSimulatePhysics(false);
+	MeshComponent->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	MeshComponent->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+	MeshComponent->ResetAllBodiesSimulatePhysics();
+}
@@ -1,39 +1,79 @@
 // Copyright Robinator Studios, Inc. All Rights Reserved.
 
 #include "Characters/Enemy/ChaosEnemy.h"
-#include "Components/WidgetComponent.h" // For UWidgetComponent
 #include "Components/ChaosAttributes.h" // For UChaosAttributes
 #include "Kismet/GameplayStatics.h" // For Delayed Destroy
 #include "GameFramework/CharacterMovementComponent.h" // For Movement Component
 #include "Components/CapsuleComponent.h" // For Capsule Component
+#include "AI/ChaosEnemyTickManager.h" // For significance-based ticking
+#include "UI/ChaosHealthBarSubsystem.h" // For pooled health bars
+#include "AI/ChaosEnemyPoolSubsystem.h" // For recycling dead enemies
+#include "AI/ChaosAIScheduler.h" // For time-sliced StateTree evaluation
+#include "AIController.h" // For the controller's brain
+#include "Components/StateTreeComponent.h" // For the StateTree brain
 
 AChaosEnemy::AChaosEnemy()
 {
 	// Set this character to call Tick() every frame. You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
-	// Create the Health Bar Widget Component
-	HealthBarWidgetComponent = CreateDefaultSubobject<UWidgetComponent>(TEXT("HealthBarWidgetComponent"));
-	HealthBarWidgetComponent->SetupAttachment(RootComponent);
-	HealthBarWidgetComponent->SetWidgetSpace(EWidgetSpace::Screen); // Display in screen space
-	HealthBarWidgetComponent->SetDrawAtDesiredSize(true); // Auto-size the widget
-	HealthBarWidgetComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision); // Widget shouldn't block anything
-	HealthBarWidgetComponent->SetVisibility(false); // Hidden by default, show on damage or proximity
-	HealthBarWidgetComponent->SetRelativeLocation(FVector(0.f, 0.f, 100.f)); // Adjust offset as needed
+	Team = EChaosTeam::Enemy;
+
+	// Health bars are drawn by the UChaosHealthBarSubsystem from a shared widget pool, not by a component per enemy.
 }
 
 void AChaosEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	// Bind to the OnHealthChanged delegate to show/hide health bar or update it
+	// Bind to the OnAttributeChanged delegate to show the health bar once the enemy got hurt.
+	// Changes are coalesced and delivered once per frame, so the health bar never has to poll.
 	if (AttributesComponent)
 	{
-		// Note: UChaosAttributes currently doesn't have an OnHealthChanged delegate.
-		// We would typically bind to it here. For now, we'll handle visibility when damage is taken.
-		// If you add a delegate like DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnHealthChangedDelegate); in ChaosAttributes.h,
-		// and broadcast it in ApplyHealthChange, you can bind to it here:
-		// AttributesComponent->OnHealthChanged.AddDynamic(this, &AChaosEnemy::HandleHealthChanged);
+		AttributesComponent->OnAttributeChanged.AddDynamic(this, &AChaosEnemy::HandleAttributeChanged);
+	}
+
+	// Let the tick manager scale our update rate with our significance to the player.
+	if (UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>())
+	{
+		TickManager->RegisterEnemy(this);
+	}
+
+	// Our StateTree brain is evaluated by the AI scheduler within its frame budget instead of ticking on its own.
+	if (UChaosAIScheduler* AIScheduler = GetWorld()->GetSubsystem<UChaosAIScheduler>())
+	{
+		AIScheduler->RegisterBrain(this, FindStateTreeBrain());
+	}
+}
+
+void AChaosEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>())
+	{
+		TickManager->UnregisterEnemy(this);
+	}
+	if (UChaosAIScheduler* AIScheduler = GetWorld()->GetSubsystem<UChaosAIScheduler>())
+	{
+		AIScheduler->UnregisterBrain(this);
+	}
+	SetHealthBarVisibility(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AChaosEnemy::HandleAttributeChanged(UChaosAttributes* Attributes, EChaosAttribute Attribute, float OldValue, float NewValue)
+{
+	if (Attribute != EChaosAttribute::Health)
+	{
+		return;
+	}
+
+	// Only show the health bar while the enemy is hurt but alive. Death hides it in Die_Implementation.
+	SetHealthBarVisibility(NewValue > 0.f && NewValue < Attributes->GetMaxHealth());
+
+	if (UChaosHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UChaosHealthBarSubsystem>())
+	{
+		HealthBars->NotifyHealthChanged(this);
 	}
 }
 
@@ -41,6 +81,18 @@ void AChaosEnemy::Die_Implementation()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Enemy '%s' has died!"), *GetNameSafe(this));
 
+	// Dead enemies are no longer managed; this also restores the full tick rate for the death sequence.
+	if (UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>())
+	{
+		TickManager->UnregisterEnemy(this);
+	}
+
+	// Dead enemies stop thinking.
+	if (UChaosAIScheduler* AIScheduler = GetWorld()->GetSubsystem<UChaosAIScheduler>())
+	{
+		AIScheduler->UnregisterBrain(this);
+	}
+
 	// Call the base CharacterBase death logic (ragdoll, disable movement, etc.)
 	Super::Die_Implementation();
 
@@ -53,14 +105,67 @@ void AChaosEnemy::Die_Implementation()
 		GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
 
-	// Destroy the actor after a short delay (e.g., after death animation/ragdoll settles)
-	SetLifeSpan(5.0f); // Actor will be destroyed after 5 seconds
+	// Recycle the actor after a short delay (e.g., after death animation/ragdoll settles).
+	// Without a pool (e.g. in editor previews) it is destroyed instead.
+	if (GetWorld()->GetSubsystem<UChaosEnemyPoolSubsystem>())
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_ReturnToPool, this, &AChaosEnemy::ReturnToPool, FMath::Max(CorpseLifeSpan, KINDA_SMALL_NUMBER), false);
+	}
+	else
+	{
+		SetLifeSpan(FMath::Max(CorpseLifeSpan, KINDA_SMALL_NUMBER));
+	}
+}
+
+void AChaosEnemy::ReturnToPool()
+{
+	if (UChaosEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UChaosEnemyPoolSubsystem>())
+	{
+		EnemyPool->ReleaseEnemy(this);
+	}
+}
+
+void AChaosEnemy::DeactivateForPool()
+{
+	// Unregistering restores full tick rates, so it has to happen before the base class stops all ticking.
+	SetHealthBarVisibility(false);
+	if (UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>())
+	{
+		TickManager->UnregisterEnemy(this);
+	}
+	if (UChaosAIScheduler* AIScheduler = GetWorld()->GetSubsystem<UChaosAIScheduler>())
+	{
+		AIScheduler->UnregisterBrain(this);
+	}
+
+	Super::DeactivateForPool();
+}
+
+void AChaosEnemy::ReactivateFromPool()
+{
+	Super::ReactivateFromPool();
+
+	if (UChaosEnemyTickManager* TickManager = GetWorld()->GetSubsystem<UChaosEnemyTickManager>())
+	{
+		TickManager->RegisterEnemy(this);
+	}
+	if (UChaosAIScheduler* AIScheduler = GetWorld()->GetSubsystem<UChaosAIScheduler>())
+	{
+		AIScheduler->RegisterBrain(this, FindStateTreeBrain());
+	}
+}
+
+UStateTreeComponent* AChaosEnemy::FindStateTreeBrain() const
+{
+	const AAIController* AIController = Cast<AAIController>(GetController());
+	return AIController ? Cast<UStateTreeComponent>(AIController->GetBrainComponent()) : nullptr;
 }
 
 void AChaosEnemy::SetHealthBarVisibility(bool bVisible)
 {
-	if (HealthBarWidgetComponent)
+	// The subsystem decides which of the requesting enemies actually get one of its pooled widgets.
+	if (UChaosHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UChaosHealthBarSubsystem>())
 	{
-		HealthBarWidgetComponent->SetVisibility(bVisible);
+		HealthBars->SetHealthBarRequested(this, bVisible);
 	}
 }
@@ -1,10 +1,19 @@
 // Copyright Robinator Studios, Inc. All Rights Reserved.
 
 #include "Characters/Enemy/ChaosEnemyMelee.h"
-#include "Kismet/GameplayStatics.h" // For ApplyDamage
+#include "Combat/ChaosDamageSubsystem.h" // For QueueDamage
 #include "GameFramework/CharacterMovementComponent.h" // For checking movement
 #include "Components/CapsuleComponent.h" // For character dimensions
 #include "Animation/AnimInstance.h" // For playing montages
+#include "Combat/ChaosTargetIndexSubsystem.h" // For candidate target queries
+#include "Combat/ChaosMeleeQuerySubsystem.h" // For asynchronous melee sweeps
+#include "Core/ChaosCombatTrace.h" // For tracing melee hits
+
+namespace ChaosEnemyMeleeCooldowns
+{
+	// Prevents attack spamming. Kept in the UChaosCooldownSubsystem.
+	static const FName Attack(TEXT("Attack"));
+}
 
 AChaosEnemyMelee::AChaosEnemyMelee()
 {
@@ -22,7 +31,7 @@ void AChaosEnemyMelee::StartAttack()
 {
 	// Only proceed if the enemy can attack and is not vaulting (if vaulting is a shared feature)
 	// Assuming melee enemies won't vault during an attack
-	if (!bCanAttack)
+	if (!IsCooldownReady(ChaosEnemyMeleeCooldowns::Attack))
 	{
 		return;
 	}
@@ -32,8 +41,7 @@ void AChaosEnemyMelee::StartAttack()
 		PlayAnimMontage(MeleeAttackMontage);
 
 		// Set cooldown based on animation length
-		bCanAttack = false;
-		GetWorld()->GetTimerManager().SetTimer(TimerHandle_AttackCooldown, this, &AChaosEnemyMelee::ResetAttackCooldown, MeleeAttackMontage->GetPlayLength() * 0.9f, false);
+		StartCooldown(ChaosEnemyMeleeCooldowns::Attack, MeleeAttackMontage->GetPlayLength() * 0.9f);
 		// Cooldown set to 90% of animation length to allow for some recovery before next attack
 
 		// --- Hitbox Check ---
@@ -41,41 +49,30 @@ void AChaosEnemyMelee::StartAttack()
 		FVector StartLocation = GetActorLocation() + GetActorForwardVector() * GetCapsuleComponent()->GetScaledCapsuleRadius();
 		FVector EndLocation = StartLocation + GetActorForwardVector() * MeleeAttackRange;
 		
-		TArray<FHitResult> HitResults;
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this); // Ignore the enemy itself
-
 		// Define the type of damage event (can be customized later, e.g., UMeleeDamageType::StaticClass())
 		TSubclassOf<UDamageType> DamageTypeClass = UDamageType::StaticClass();
 
-		bool bHit = GetWorld()->SweepMultiByChannel(
-			HitResults,
-			StartLocation,
-			EndLocation,
-			FQuat::Identity,
-			ECC_Pawn, // Check for other Pawns (which includes AChaosCharacter and other enemies)
-			FCollisionShape::MakeSphere(MeleeAttackRadius),
-			QueryParams
-		);
-
-		if (bHit)
+		// Asynchronous sweeps deal their damage through the melee query subsystem once the results are in.
+		UChaosMeleeQuerySubsystem* MeleeQueries = GetWorld()->GetSubsystem<UChaosMeleeQuerySubsystem>();
+		if (MeleeQueryMode == EChaosMeleeQueryMode::AsyncSweep && MeleeQueries)
 		{
-			for (const FHitResult& Hit : HitResults)
-			{
-				// Attempt to cast to AChaosCharacterBase to ensure we hit a valid combatant
-				AChaosCharacterBase* HitCharacter = Cast<AChaosCharacterBase>(Hit.GetActor());
-				if (HitCharacter && HitCharacter != this) // Ensure we don't hit ourselves
-				{
-					UGameplayStatics::ApplyDamage(
-						HitCharacter,
-						MeleeDamage,
-						GetController(),
-						this,
-						DamageTypeClass
-					);
-					UE_LOG(LogTemp, Log, TEXT("Enemy Melee attack hit: %s"), *GetNameSafe(HitCharacter));
-				}
-			}
+			MeleeQueries->SubmitMeleeSweep(this, StartLocation, EndLocation, MeleeAttackRadius, MeleeDamage, DamageTypeClass);
+			return;
+		}
+
+		TArray<AChaosCharacterBase*> HitCharacters;
+		FindMeleeTargets(StartLocation, EndLocation, HitCharacters);
+
+		for (AChaosCharacterBase* HitCharacter : HitCharacters)
+		{
+			UChaosDamageSubsystem::QueueDamage(
+				HitCharacter,
+				MeleeDamage,
+				GetController(),
+				this,
+				DamageTypeClass
+			);
+			FChaosCombatTrace::Record(EChaosCombatEvent::MeleeHit, this, HitCharacter, MeleeDamage);
 		}
 
 		// Optional: Debug visualization of the attack area
@@ -87,7 +84,66 @@ void AChaosEnemyMelee::StartAttack()
 	}
 }
 
-void AChaosEnemyMelee::ResetAttackCooldown()
+void AChaosEnemyMelee::FindMeleeTargets(const FVector& Start, const FVector& End, TArray<AChaosCharacterBase*>& OutHitCharacters) const
 {
-	bCanAttack = true;
+	OutHitCharacters.Reset();
+
+	UChaosTargetIndexSubsystem* TargetIndex = GetWorld()->GetSubsystem<UChaosTargetIndexSubsystem>();
+	if (MeleeQueryMode == EChaosMeleeQueryMode::TargetIndex && TargetIndex)
+	{
+		// Broad phase: hostile characters around the attack segment, straight from the grid.
+		TArray<AChaosCharacterBase*> Candidates;
+		const FVector Center = (Start + End) * 0.5f;
+		const float QueryRadius = FVector::Dist2D(Start, End) * 0.5f + MeleeAttackRadius;
+		TargetIndex->QueryCharacters(Center, QueryRadius, GetTeam(), Candidates);
+
+		// Narrow phase: the attack sphere moved along the segment against each candidate's capsule.
+		for (AChaosCharacterBase* Candidate : Candidates)
+		{
+			const UCapsuleComponent* Capsule = Candidate->GetCapsuleComponent();
+			if (Candidate == this || !Capsule)
+			{
+				continue;
+			}
+
+			const FVector CapsuleCenter = Capsule->GetComponentLocation();
+			const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+			const FVector CapsuleAxis = FVector(0.f, 0.f, Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere());
+
+			FVector ClosestOnAttack, ClosestOnCapsule;
+			FMath::SegmentDistToSegmentSafe(Start, End, CapsuleCenter - CapsuleAxis, CapsuleCenter + CapsuleAxis, ClosestOnAttack, ClosestOnCapsule);
+			if (FVector::DistSquared(ClosestOnAttack, ClosestOnCapsule) <= FMath::Square(MeleeAttackRadius + CapsuleRadius))
+			{
+				OutHitCharacters.Add(Candidate);
+			}
+		}
+		return;
+	}
+
+	TArray<FHitResult> HitResults;
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this); // Ignore the enemy itself
+
+	bool bHit = GetWorld()->SweepMultiByChannel(
+		HitResults,
+		Start,
+		End,
+		FQuat::Identity,
+		ECC_Pawn, // Check for other Pawns (which includes AChaosCharacter and other enemies)
+		FCollisionShape::MakeSphere(MeleeAttackRadius),
+		QueryParams
+	);
+
+	if (bHit)
+	{
+		for (const FHitResult& Hit : HitResults)
+		{
+			// Attempt to cast to AChaosCharacterBase to ensure we hit a valid combatant
+			AChaosCharacterBase* HitCharacter = Cast<AChaosCharacterBase>(Hit.GetActor());
+			if (HitCharacter && HitCharacter != this) // Ensure we don't hit ourselves
+			{
+				OutHitCharacters.AddUnique(HitCharacter);
+			}
+		}
+	}
 }
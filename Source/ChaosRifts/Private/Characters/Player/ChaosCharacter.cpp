@@ -10,13 +10,15 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Animation/AnimInstance.h"
 #include "Kismet/GameplayStatics.h" // For ApplyDamage
 #include "Components/ChaosAttributes.h" // For accessing Chaos resource
 #include "Core/ChaosGameMode.h" // For GameMode access to handle Game Over
 #include "Characters/Enemy/ChaosEnemy.h" // To recognize AChaosEnemy type in melee attack
 #include "Items/Weapons/Weapon.h" // Include Weapon
+#include "Items/Weapons/ChaosWeaponComponent.h" // For weapons carried as components
+#include "Core/ChaosCombatTrace.h" // For tracing combat events
+#include "Movement/ChaosLedgeSubsystem.h" // For baked mantle ledges
 
 // NO CHANGES ARE NEEDED IN THIS FILE (Original user comment, adapted here)
 // The include path above correctly finds the header.
@@ -24,6 +26,40 @@
 
 DEFINE_LOG_CATEGORY(LogChaosCharacter);
 
+// The cooldowns this character keeps in the UChaosCooldownSubsystem.
+namespace ChaosCharacterCooldowns
+{
+	static const FName Dash(TEXT("Dash"));
+	static const FName PostDashSpeed(TEXT("PostDashSpeed"));
+	static const FName Vault(TEXT("Vault"));
+	static const FName ComboWindow(TEXT("ComboWindow"));
+	static const FName SpellCast(TEXT("SpellCast"));
+}
+
+// The mantle trajectory is two legs with the shape of a continuous VInterpTo, each cut off where the interpolation
+// would have come within ArrivalTolerance of its target and rescaled to arrive exactly there.
+namespace ChaosMantleTrajectory
+{
+	static constexpr float ArrivalTolerance = 10.f;
+
+	static float GetLegDuration(const FVector& From, const FVector& To, float Speed)
+	{
+		const float Distance = FVector::Dist(From, To);
+		return Distance > ArrivalTolerance ? FMath::Loge(Distance / ArrivalTolerance) / Speed : 0.f;
+	}
+
+	static FVector EvaluateLeg(const FVector& From, const FVector& To, float Time, float Duration, float Speed)
+	{
+		if (Time >= Duration)
+		{
+			return To;
+		}
+
+		const float Alpha = (1.f - FMath::Exp(-Speed * Time)) / (1.f - FMath::Exp(-Speed * Duration));
+		return FMath::Lerp(From, To, Alpha);
+	}
+}
+
 AChaosCharacter::AChaosCharacter()
 {
 	// NOTE: The base class constructor is called automatically before this one.
@@ -31,6 +67,8 @@ AChaosCharacter::AChaosCharacter()
 
 	PrimaryActorTick.bCanEverTick = true;
 
+	Team = EChaosTeam::Player;
+
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
 	bUseControllerRotationPitch = false;
@@ -57,10 +95,24 @@ AChaosCharacter::AChaosCharacter()
 	FollowCamera->bUsePawnControlRotation = false;
 }
 
+void AChaosCharacter::PostLoad()
+{
+	Super::PostLoad();
+
+	// Blueprints saved before spells fired projectile records still carry the projectile actor class.
+	if (SpellProjectileClass_DEPRECATED)
+	{
+		if (!SpellProjectile.VisualClass)
+		{
+			SpellProjectile.VisualClass = SpellProjectileClass_DEPRECATED;
+		}
+		SpellProjectileClass_DEPRECATED = nullptr;
+	}
+}
+
 void AChaosCharacter::BeginPlay()
 {
 	Super::BeginPlay(); // Now calls AChaosCharacterBase::BeginPlay()
-	DefaultGravityScale = GetCharacterMovement()->GravityScale;
 
 	// Bind the OnDeath delegate for the player character to a specific handler
 	// The delegate requires a function that takes an AChaosCharacterBase* parameter.
@@ -78,22 +130,38 @@ void AChaosCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime); // Now calls AChaosCharacterBase::Tick()
 
-	if (bIsVaulting)
+	// The actor only ticks while one of these states is active, see SetTickState.
+	if (HasTickState(EChaosTickState::Mantling))
 	{
 		TickMantle(DeltaTime);
 	}
-	else if (bCanCheckVault)
+	else if (HasTickState(EChaosTickState::VaultCheck))
 	{
 		TickVaultCheck(DeltaTime);
 	}
+}
+
+void AChaosCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	UpdateVaultCheckTickState();
+}
+
+void AChaosCharacter::MoveBlockedBy(const FHitResult& Impact)
+{
+	Super::MoveBlockedBy(Impact);
 
-	UAnimInstance *AnimInstance = GetMesh()->GetAnimInstance();
-	if (DashMontage && AnimInstance && AnimInstance->Montage_IsPlaying(DashMontage))
+	// A dash that runs head-on into a wall should not keep playing its animation. Floors and slopes do not count.
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!DashMontage || !AnimInstance || !AnimInstance->Montage_IsPlaying(DashMontage) || Impact.ImpactNormal.Z >= GetCharacterMovement()->GetWalkableFloorZ())
 	{
-		if (GetCharacterMovement()->Velocity.SizeSquared2D() < FMath::Square(1.0f))
-		{
-			AnimInstance->Montage_Stop(0.2f, DashMontage);
-		}
+		return;
+	}
+
+	if ((Impact.ImpactNormal.GetSafeNormal2D() | GetActorForwardVector().GetSafeNormal2D()) <= -0.7f)
+	{
+		AnimInstance->Montage_Stop(0.2f, DashMontage);
 	}
 }
 
@@ -108,6 +176,7 @@ void AChaosCharacter::SetupPlayerInputComponent(UInputComponent *PlayerInputComp
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AChaosCharacter::Move);
+		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Completed, this, &AChaosCharacter::StopMove);
 		EnhancedInputComponent->BindAction(MouseLookAction, ETriggerEvent::Triggered, this, &AChaosCharacter::Look);
 		EnhancedInputComponent->BindAction(DashAction, ETriggerEvent::Started, this, &AChaosCharacter::StartDash);
 
@@ -132,6 +201,12 @@ void AChaosCharacter::Move(const FInputActionValue &Value)
 	DoMove(MovementVector.X, MovementVector.Y);
 }
 
+void AChaosCharacter::StopMove(const FInputActionValue &Value)
+{
+	ForwardInputValue = 0.f;
+	UpdateVaultCheckTickState();
+}
+
 void AChaosCharacter::Look(const FInputActionValue &Value)
 {
 	const FVector2D LookAxisVector = Value.Get<FVector2D>();
@@ -141,6 +216,7 @@ void AChaosCharacter::Look(const FInputActionValue &Value)
 void AChaosCharacter::DoMove(float Right, float Forward)
 {
 	this->ForwardInputValue = Forward;
+	UpdateVaultCheckTickState();
 
 	if (Controller != nullptr && !bIsVaulting)
 	{
@@ -165,7 +241,7 @@ void AChaosCharacter::DoLook(float Yaw, float Pitch)
 // --- Dash System ---
 void AChaosCharacter::StartDash()
 {
-	if (!bCanDash || bIsVaulting)
+	if (!IsCooldownReady(ChaosCharacterCooldowns::Dash) || bIsVaulting)
 	{
 		return;
 	}
@@ -175,17 +251,16 @@ void AChaosCharacter::StartDash()
 		PlayAnimMontage(DashMontage);
 	}
 
-	bCanDash = false;
 	LaunchCharacter(GetActorForwardVector() * DashImpulse, true, true);
 	ApplyPostDashSpeedBoost();
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_DashCooldown, this, &AChaosCharacter::ResetDashCooldown, DashCooldown, false);
+	StartCooldown(ChaosCharacterCooldowns::Dash, DashCooldown);
 }
 
 void AChaosCharacter::ApplyPostDashSpeedBoost()
 {
-	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_PostDashSpeed);
+	// Restarting the cooldown extends a running boost.
 	GetCharacterMovement()->MaxWalkSpeed = MovementSpeedDefault * PostDashSpeedBoostMultiplier;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_PostDashSpeed, this, &AChaosCharacter::ResetMovementSpeed, PostDashSpeedBoostDuration, false);
+	StartCooldown(ChaosCharacterCooldowns::PostDashSpeed, PostDashSpeedBoostDuration, FSimpleDelegate::CreateUObject(this, &AChaosCharacter::ResetMovementSpeed));
 }
 
 void AChaosCharacter::ResetMovementSpeed()
@@ -193,59 +268,170 @@ void AChaosCharacter::ResetMovementSpeed()
 	GetCharacterMovement()->MaxWalkSpeed = MovementSpeedDefault;
 }
 
-void AChaosCharacter::ResetDashCooldown()
+// --- Mantle System ---
+void AChaosCharacter::UpdateVaultCheckTickState()
 {
-	bCanDash = true;
+	// Ledges are only looked for while airborne, moving forward and not already mantling.
+	const bool bWantsVaultCheck = !bIsVaulting && ForwardInputValue >= 0.1f && GetCharacterMovement()->IsFalling() && IsCooldownReady(ChaosCharacterCooldowns::Vault);
+	if (!bWantsVaultCheck)
+	{
+		MantleProbe.Stage = EMantleProbeStage::Idle;
+	}
+	SetTickState(EChaosTickState::VaultCheck, bWantsVaultCheck);
 }
 
-// --- Mantle System ---
 void AChaosCharacter::TickVaultCheck(float DeltaTime)
 {
-	if (!GetCharacterMovement()->IsFalling() || ForwardInputValue < 0.1f)
+	const FVector CameraDirection = FollowCamera->GetForwardVector().GetSafeNormal();
+	const FVector ActorDirection = GetActorForwardVector().GetSafeNormal();
+	if (!GetCharacterMovement()->IsFalling() || ForwardInputValue < 0.1f || FVector::DotProduct(CameraDirection, ActorDirection) < MantleActivationDotProduct)
 	{
+		// A probe in flight no longer matters; its results are simply never read.
+		MantleProbe.Stage = EMantleProbeStage::Idle;
 		return;
 	}
 
-	const FVector CameraDirection = FollowCamera->GetForwardVector().GetSafeNormal();
-	const FVector ActorDirection = GetActorForwardVector().GetSafeNormal();
-	if (FVector::DotProduct(CameraDirection, ActorDirection) < MantleActivationDotProduct)
+	// Baked ledges are mantled right away. Only static meshes are baked, so a miss falls back to the trace probe,
+	// which also finds ledges on BSP, landscapes and movable geometry.
+	const UChaosLedgeSubsystem* Ledges = GetWorld()->GetSubsystem<UChaosLedgeSubsystem>();
+	if (Ledges)
 	{
-		return;
+		// The probe's upper trace rejects walls reaching above chest height, so the baked query caps the height there too.
+		const float CapsuleRadius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+		const float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		FChaosLedgeHit Ledge;
+		if (Ledges->FindLedge(GetActorLocation(), ActorDirection, MantleTraceDistance, MinMantleHeight, FMath::Min(MaxMantleHeight, CapsuleHalfHeight / 1.5f), Ledge))
+		{
+			MantleProbe.Stage = EMantleProbeStage::Idle;
+			const FVector IntoLedge = -Ledge.Normal;
+			const FVector LedgePoint = ChaosLedges::GetLedgePoint(Ledge.Point, IntoLedge);
+			PerformMantle(ChaosLedges::GetLandingLocation(LedgePoint, IntoLedge, CapsuleRadius, CapsuleHalfHeight), LedgePoint);
+			return;
+		}
 	}
 
-	const FVector ActorLocation = GetActorLocation();
-	const FVector ForwardVector = GetActorForwardVector();
-	const float CapsuleRadius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+	if (MantleProbe.Stage != EMantleProbeStage::Idle)
+	{
+		AdvanceMantleProbe();
+	}
+	else if (!IsMantleProbeCached())
+	{
+		StartMantleProbe();
+	}
+}
+
+void AChaosCharacter::StartMantleProbe()
+{
 	const float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-	FHitResult FrontHit, LedgeHit, LandingSpaceHit;
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosMantleProbe), false, this);
 
-	FVector FrontTraceStart = ActorLocation;
+	MantleProbe.Stage = EMantleProbeStage::Wall;
+	MantleProbe.Origin = GetActorLocation();
+	MantleProbe.Forward = GetActorForwardVector();
+	MantleProbe.Wall = nullptr;
+
+	// The front trace looks for the wall, the upper trace makes sure it is low enough to climb.
+	FVector FrontTraceStart = MantleProbe.Origin;
 	FrontTraceStart.Z -= CapsuleHalfHeight / 2;
-	const FVector FrontTraceEnd = FrontTraceStart + ForwardVector * MantleTraceDistance;
-	if (!UKismetSystemLibrary::LineTraceSingle(this, FrontTraceStart, FrontTraceEnd, UEngineTypes::ConvertToTraceType(ECC_WorldStatic), false, {}, EDrawDebugTrace::None, FrontHit, true))
+	const FVector UpperTraceStart = MantleProbe.Origin + FVector(0, 0, CapsuleHalfHeight / 1.5f);
+	MantleProbe.Handles[0] = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, FrontTraceStart, FrontTraceStart + MantleProbe.Forward * MantleTraceDistance, ECC_WorldStatic, QueryParams);
+	MantleProbe.Handles[1] = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, UpperTraceStart, UpperTraceStart + MantleProbe.Forward * MantleTraceDistance, ECC_WorldStatic, QueryParams);
+}
+
+void AChaosCharacter::AdvanceMantleProbe()
+{
+	UWorld* World = GetWorld();
+	const float CapsuleRadius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+	const float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosMantleProbe), false, this);
+
+	switch (MantleProbe.Stage)
+	{
+	case EMantleProbeStage::Wall:
 	{
+		FTraceDatum FrontData, UpperData;
+		if (!World->QueryTraceData(MantleProbe.Handles[0], FrontData) || !World->QueryTraceData(MantleProbe.Handles[1], UpperData))
+		{
+			// The results expired (e.g. after a hitch); start over.
+			MantleProbe.Stage = EMantleProbeStage::Idle;
+			return;
+		}
+
+		const FHitResult* FrontHit = FHitResult::GetFirstBlockingHit(FrontData.OutHits);
+		if (FrontHit)
+		{
+			MantleProbe.Wall = FrontHit->GetComponent();
+			MantleProbe.WallPoint = FrontHit->ImpactPoint;
+		}
+
+		if (!FrontHit || FHitResult::GetFirstBlockingHit(UpperData.OutHits))
+		{
+			FailMantleProbe();
+			return;
+		}
+
+		const FVector LedgeTraceStart = FVector(MantleProbe.WallPoint.X, MantleProbe.WallPoint.Y, MantleProbe.Origin.Z + MaxMantleHeight) + MantleProbe.Forward * ChaosLedges::LedgeInset;
+		MantleProbe.Handles[0] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, LedgeTraceStart, LedgeTraceStart - FVector(0, 0, MaxMantleHeight - MinMantleHeight), ECC_WorldStatic, QueryParams);
+		MantleProbe.Stage = EMantleProbeStage::Ledge;
 		return;
 	}
 
-	const FVector UpperTraceStart = ActorLocation + FVector(0, 0, CapsuleHalfHeight / 1.5f);
-	if (UKismetSystemLibrary::LineTraceSingle(this, UpperTraceStart, UpperTraceStart + ForwardVector * MantleTraceDistance, UEngineTypes::ConvertToTraceType(ECC_WorldStatic), false, {}, EDrawDebugTrace::None, LandingSpaceHit, true))
+	case EMantleProbeStage::Ledge:
 	{
+		FTraceDatum LedgeData;
+		const FHitResult* LedgeHit = World->QueryTraceData(MantleProbe.Handles[0], LedgeData) ? FHitResult::GetFirstBlockingHit(LedgeData.OutHits) : nullptr;
+		if (!LedgeHit)
+		{
+			FailMantleProbe();
+			return;
+		}
+
+		MantleProbe.LedgePoint = LedgeHit->ImpactPoint;
+		MantleProbe.LandingLocation = ChaosLedges::GetLandingLocation(MantleProbe.LedgePoint, MantleProbe.Forward, CapsuleRadius, CapsuleHalfHeight);
+		MantleProbe.Handles[0] = World->AsyncOverlapByChannel(MantleProbe.LandingLocation, FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), QueryParams);
+		MantleProbe.Stage = EMantleProbeStage::LandingSpace;
 		return;
 	}
 
-	const FVector LedgeTraceStart = FVector(FrontHit.ImpactPoint.X, FrontHit.ImpactPoint.Y, ActorLocation.Z + MaxMantleHeight) + ForwardVector * 15.f;
-	if (!UKismetSystemLibrary::LineTraceSingle(this, LedgeTraceStart, LedgeTraceStart - FVector(0, 0, MaxMantleHeight - MinMantleHeight), UEngineTypes::ConvertToTraceType(ECC_WorldStatic), false, {}, EDrawDebugTrace::None, LedgeHit, true))
+	case EMantleProbeStage::LandingSpace:
 	{
+		FOverlapDatum LandingData;
+		const bool bLandingBlocked = !World->QueryOverlapData(MantleProbe.Handles[0], LandingData)
+			|| LandingData.OutOverlaps.ContainsByPredicate([](const FOverlapResult& Overlap) { return Overlap.bBlockingHit; });
+		if (bLandingBlocked)
+		{
+			FailMantleProbe();
+			return;
+		}
+
+		MantleProbe.Stage = EMantleProbeStage::Idle;
+		MantleProbeCache.bValid = false;
+		PerformMantle(MantleProbe.LandingLocation, MantleProbe.LedgePoint);
 		return;
 	}
 
-	const FVector LandingLocation = LedgeHit.ImpactPoint + (ForwardVector * CapsuleRadius * 1.5f) + FVector(0, 0, CapsuleHalfHeight + 5.f);
-	if (UKismetSystemLibrary::CapsuleTraceSingle(this, LandingLocation, LandingLocation, CapsuleRadius, CapsuleHalfHeight, UEngineTypes::ConvertToTraceType(ECC_WorldStatic), false, {}, EDrawDebugTrace::None, LandingSpaceHit, true))
-	{
+	default:
 		return;
 	}
+}
 
-	PerformMantle(LandingLocation, LedgeHit.ImpactPoint);
+void AChaosCharacter::FailMantleProbe()
+{
+	MantleProbeCache.bValid = true;
+	MantleProbeCache.Location = MantleProbe.Origin;
+	MantleProbeCache.Forward = MantleProbe.Forward;
+	MantleProbeCache.Wall = MantleProbe.Wall;
+	MantleProbeCache.bHitWall = MantleProbe.Wall.IsValid();
+	MantleProbe.Stage = EMantleProbeStage::Idle;
+}
+
+bool AChaosCharacter::IsMantleProbeCached() const
+{
+	// The same spot, the same direction and (if there was one) the same wall give the same result as last time.
+	return MantleProbeCache.bValid
+		&& FVector::DistSquared(GetActorLocation(), MantleProbeCache.Location) <= FMath::Square(MantleProbeCacheDistance)
+		&& FVector::DotProduct(GetActorForwardVector(), MantleProbeCache.Forward) >= 0.99f
+		&& (!MantleProbeCache.bHitWall || MantleProbeCache.Wall.IsValid());
 }
 
 void AChaosCharacter::PerformMantle(const FVector &LandingTarget, const FVector &LedgePosition)
@@ -258,45 +444,50 @@ void AChaosCharacter::PerformMantle(const FVector &LandingTarget, const FVector
 	}
 
 	bIsVaulting = true;
-	MantleLerpSpeed = GetSpeed() > MantleFastSpeedThreshold ? MantleLerpSpeedFast : MantleLerpSpeedNormal;
 	CurrentMantleState = EMantleState::Reaching;
-	MantleTargetLocation = LandingTarget;
-
-	MantleLedgeLocation = LedgePosition;
-	MantleLedgeLocation.Z += GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-	MantleLedgeLocation += GetActorForwardVector() * 5.f;
-
-	GetCharacterMovement()->SetMovementMode(MOVE_Flying);
+	SetTickState(EChaosTickState::Mantling, true);
+
+	// Plan the whole movement now; TickMantle only samples it.
+	FMantleTrajectory& Trajectory = MantleTrajectory;
+	Trajectory.Speed = FMath::Max(GetSpeed() > MantleFastSpeedThreshold ? MantleLerpSpeedFast : MantleLerpSpeedNormal, KINDA_SMALL_NUMBER);
+	Trajectory.Start = GetActorLocation();
+	Trajectory.Ledge = LedgePosition + FVector(0, 0, GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) + GetActorForwardVector() * 5.f;
+	Trajectory.Landing = LandingTarget;
+	Trajectory.ReachDuration = ChaosMantleTrajectory::GetLegDuration(Trajectory.Start, Trajectory.Ledge, Trajectory.Speed);
+	Trajectory.PushDuration = ChaosMantleTrajectory::GetLegDuration(Trajectory.Ledge, Trajectory.Landing, Trajectory.Speed);
+	Trajectory.Time = 0.f;
+
+	// The custom mode stops the movement component from moving or sweeping the capsule, so the wall needs no
+	// collision response change. Overlaps are refreshed once when the mantle ends.
+	GetCharacterMovement()->SetMovementMode(MOVE_Custom, static_cast<uint8>(EChaosCustomMovementMode::Mantle));
 	GetCharacterMovement()->Velocity = FVector::ZeroVector;
-	GetCharacterMovement()->GravityScale = 0.0f;
-	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Ignore);
+	bMantleDeferredOverlaps = GetCapsuleComponent()->GetGenerateOverlapEvents();
+	GetCapsuleComponent()->SetGenerateOverlapEvents(false);
 }
 
 void AChaosCharacter::TickMantle(float DeltaTime)
 {
-	FVector CurrentTarget;
+	FMantleTrajectory& Trajectory = MantleTrajectory;
+	Trajectory.Time += DeltaTime;
 
-	if (CurrentMantleState == EMantleState::Reaching)
+	FVector NewLocation;
+	if (Trajectory.Time < Trajectory.ReachDuration)
 	{
-		CurrentTarget = MantleLedgeLocation;
-		if (FVector::DistSquared(GetActorLocation(), CurrentTarget) < 100.f)
-		{
-			CurrentMantleState = EMantleState::PushingForward;
-		}
+		NewLocation = ChaosMantleTrajectory::EvaluateLeg(Trajectory.Start, Trajectory.Ledge, Trajectory.Time, Trajectory.ReachDuration, Trajectory.Speed);
 	}
-	else // PushingForward
+	else
 	{
-		CurrentTarget = MantleTargetLocation;
-		UAnimInstance *AnimInstance = GetMesh()->GetAnimInstance();
-		if (FVector::DistSquared(GetActorLocation(), CurrentTarget) < 100.f || (CurrentMantleMontage && AnimInstance && !AnimInstance->Montage_IsPlaying(CurrentMantleMontage)))
-		{
-			EndMantle();
-			return;
-		}
+		CurrentMantleState = EMantleState::PushingForward;
+		NewLocation = ChaosMantleTrajectory::EvaluateLeg(Trajectory.Ledge, Trajectory.Landing, Trajectory.Time - Trajectory.ReachDuration, Trajectory.PushDuration, Trajectory.Speed);
 	}
 
-	const FVector NewLocation = FMath::VInterpTo(GetActorLocation(), CurrentTarget, DeltaTime, MantleLerpSpeed);
-	SetActorLocation(NewLocation);
+	// The landing space was checked before the mantle started, so the capsule is placed without a sweep.
+	SetActorLocation(NewLocation, false, nullptr, ETeleportType::None);
+
+	if (Trajectory.Time >= Trajectory.ReachDuration + Trajectory.PushDuration)
+	{
+		EndMantle();
+	}
 }
 
 void AChaosCharacter::EndMantle()
@@ -307,18 +498,16 @@ void AChaosCharacter::EndMantle()
 	bIsVaulting = false;
 	CurrentMantleMontage = nullptr;
 	CurrentMantleState = EMantleState::None;
+	SetTickState(EChaosTickState::Mantling, false);
 
 	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
-	GetCharacterMovement()->GravityScale = DefaultGravityScale;
-	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
-
-	bCanCheckVault = false;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_VaultCooldown, this, &AChaosCharacter::ResetVaultCooldown, MantleCooldownDuration, false);
-}
+	if (bMantleDeferredOverlaps)
+	{
+		GetCapsuleComponent()->SetGenerateOverlapEvents(true);
+		GetCapsuleComponent()->UpdateOverlaps();
+	}
 
-void AChaosCharacter::ResetVaultCooldown()
-{
-	bCanCheckVault = true;
+	StartCooldown(ChaosCharacterCooldowns::Vault, MantleCooldownDuration, FSimpleDelegate::CreateUObject(this, &AChaosCharacter::UpdateVaultCheckTickState));
 }
 
 // --- Melee System ---
@@ -332,7 +521,7 @@ void AChaosCharacter::StartAttack()
 		return;
 	}
 
-	if (bInComboWindow)
+	if (!IsCooldownReady(ChaosCharacterCooldowns::ComboWindow))
 	{
 		CurrentComboIndex = (CurrentComboIndex + 1) % MeleeAttackMontages.Num();
 	}
@@ -347,8 +536,7 @@ void AChaosCharacter::StartAttack()
 		PlayAnimMontage(MontageToPlay);
 
 		bCanAttack = false;
-		bInComboWindow = false; 
-		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_ComboWindow);
+		CancelCooldown(ChaosCharacterCooldowns::ComboWindow);
 
 		// IMPORTANT: The Damage Logic (Sphere Trace) was removed here.
 		// The Weapon is now controlled by Anim Notifies.
@@ -365,7 +553,12 @@ void AChaosCharacter::EnableWeaponHitDetection()
 	if (CurrentWeapon)
 	{
 		CurrentWeapon->SetWeaponState(EWeaponState::Aggressive);
-		UE_LOG(LogChaosCharacter, Log, TEXT("Weapon hit detection ENABLED"));
+		FChaosCombatTrace::Record(EChaosCombatEvent::WeaponHitDetectionEnabled, this, CurrentWeapon, CurrentWeapon->GetCurrentSwingId());
+	}
+	else if (UChaosWeaponComponent* WeaponComponent = GetCurrentWeaponComponent())
+	{
+		WeaponComponent->SetWeaponState(EWeaponState::Aggressive);
+		FChaosCombatTrace::Record(EChaosCombatEvent::WeaponHitDetectionEnabled, this, WeaponComponent, WeaponComponent->GetCurrentSwingId());
 	}
 }
 
@@ -374,7 +567,12 @@ void AChaosCharacter::DisableWeaponHitDetection()
 	if (CurrentWeapon)
 	{
 		CurrentWeapon->SetWeaponState(EWeaponState::Passive);
-		UE_LOG(LogChaosCharacter, Log, TEXT("Weapon hit detection DISABLED"));
+		FChaosCombatTrace::Record(EChaosCombatEvent::WeaponHitDetectionDisabled, this, CurrentWeapon, CurrentWeapon->GetCurrentSwingId());
+	}
+	else if (UChaosWeaponComponent* WeaponComponent = GetCurrentWeaponComponent())
+	{
+		WeaponComponent->SetWeaponState(EWeaponState::Passive);
+		FChaosCombatTrace::Record(EChaosCombatEvent::WeaponHitDetectionDisabled, this, WeaponComponent, WeaponComponent->GetCurrentSwingId());
 	}
 }
 
@@ -387,8 +585,7 @@ void AChaosCharacter::OnAttackMontageEnded(UAnimMontage* Montage, bool bInterrup
 		
 		if (!bInterrupted)
 		{
-			bInComboWindow = true;
-			GetWorld()->GetTimerManager().SetTimer(TimerHandle_ComboWindow, this, &AChaosCharacter::ResetCombo, ComboWindowDuration, false);
+			StartCooldown(ChaosCharacterCooldowns::ComboWindow, ComboWindowDuration, FSimpleDelegate::CreateUObject(this, &AChaosCharacter::ResetCombo));
 		}
 		else
 		{
@@ -406,9 +603,8 @@ void AChaosCharacter::ResetAttackCooldown()
 
 void AChaosCharacter::ResetCombo()
 {
-	bInComboWindow = false;
 	CurrentComboIndex = 0;
-	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_ComboWindow);
+	CancelCooldown(ChaosCharacterCooldowns::ComboWindow);
 }
 
 // --- Weapon System ---
@@ -422,7 +618,7 @@ void AChaosCharacter::HandleSwapWeapon()
 void AChaosCharacter::StartSpellCast()
 {
 	// Check if the character can cast a spell and has enough Chaos
-	if (!bCanCastSpell || bIsVaulting || !AttributesComponent || AttributesComponent->GetChaos() < SpellChaosCost)
+	if (!IsCooldownReady(ChaosCharacterCooldowns::SpellCast) || bIsVaulting || !AttributesComponent || AttributesComponent->GetChaos() < SpellChaosCost)
 	{
 		if (AttributesComponent && AttributesComponent->GetChaos() < SpellChaosCost)
 		{
@@ -445,12 +641,13 @@ void AChaosCharacter::StartSpellCast()
 	AttributesComponent->ApplyChaosChange(-SpellChaosCost);
 
 	// Set spell cast cooldown
-	bCanCastSpell = false;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_SpellCastCooldown, this, &AChaosCharacter::ResetSpellCastCooldown, SpellCastMontage ? SpellCastMontage->GetPlayLength() : 1.0f, false);
+	StartCooldown(ChaosCharacterCooldowns::SpellCast, SpellCastMontage ? SpellCastMontage->GetPlayLength() : 1.0f);
 	// If no montage, use a default cooldown of 1.0f
 
-	// --- Spawn Spell Projectile (placeholder) ---
-	if (SpellProjectileClass)
+	// --- Fire Spell Projectile ---
+	// The projectile is a record in the projectile subsystem, which moves it, shows it and deals its damage.
+	UChaosProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UChaosProjectileSubsystem>();
+	if (ProjectileSubsystem)
 	{
 		// Spawn location: a bit in front of the character's mesh
 		FVector SpawnLocation = GetMesh()->GetSocketLocation(TEXT("MuzzleSocket")); // Assuming a socket named "MuzzleSocket" on your character's mesh
@@ -458,30 +655,13 @@ void AChaosCharacter::StartSpellCast()
 		{
 			SpawnLocation = GetActorLocation() + GetActorForwardVector() * 100.f + FVector(0,0,50.f);
 		}
-		
-		FRotator SpawnRotation = GetControlRotation(); // Projectile goes where the player is looking
 
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = this;
-		SpawnParams.Instigator = GetInstigator();
-
-		AActor* Projectile = GetWorld()->SpawnActor<AActor>(SpellProjectileClass, SpawnLocation, SpawnRotation, SpawnParams);
-		if (Projectile)
+		// Projectile goes where the player is looking
+		if (!ProjectileSubsystem->FireProjectile(SpellProjectile, SpawnLocation, GetControlRotation().Vector(), this))
 		{
-			UE_LOG(LogChaosCharacter, Log, TEXT("Spawned spell projectile: %s"), *GetNameSafe(Projectile));
-			// You would typically add ProjectileMovementComponent and damage logic to the SpellProjectileClass itself
+			UE_LOG(LogChaosCharacter, Warning, TEXT("Spell projectile of %s was dropped, the projectile budget is exhausted."), *GetNameSafe(this));
 		}
 	}
-	else
-	{
-		UE_LOG(LogChaosCharacter, Warning, TEXT("SpellProjectileClass not assigned for %s"), *GetNameSafe(this));
-	}
-}
-
-// Implementation of the function to reset the spell cast cooldown
-void AChaosCharacter::ResetSpellCastCooldown()
-{
-	bCanCastSpell = true;
 }
 
 // --- Player Death Handling ---
@@ -0,0 +1,111 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Combat/ChaosDamageSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "Kismet/GameplayStatics.h"
+
+void UChaosDamageSubsystem::QueueDamage(AActor* Target, float Amount, AController* EventInstigator, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass)
+{
+	if (!Target || Amount == 0.f)
+	{
+		return;
+	}
+
+	UWorld* World = Target->GetWorld();
+	UChaosDamageSubsystem* DamageSubsystem = World ? World->GetSubsystem<UChaosDamageSubsystem>() : nullptr;
+	if (DamageSubsystem)
+	{
+		DamageSubsystem->EnqueueDamage(Target, Amount, EventInstigator, DamageCauser, DamageTypeClass);
+	}
+	else
+	{
+		UGameplayStatics::ApplyDamage(Target, Amount, EventInstigator, DamageCauser, DamageTypeClass);
+	}
+}
+
+void UChaosDamageSubsystem::EnqueueDamage(AActor* Target, float Amount, AController* EventInstigator, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass)
+{
+	FChaosPendingDamage& Entry = PendingDamage.AddDefaulted_GetRef();
+	Entry.Target = Target;
+	Entry.Causer = DamageCauser;
+	Entry.Instigator = EventInstigator;
+	Entry.DamageTypeClass = DamageTypeClass;
+	Entry.Amount = Amount;
+}
+
+void UChaosDamageSubsystem::ResolvePendingDamage()
+{
+	if (PendingDamage.Num() == 0)
+	{
+		return;
+	}
+
+	// Swap the buffers so that any damage caused while resolving (e.g. by death reactions) lands in the next pass.
+	Swap(PendingDamage, ResolvingDamage);
+
+	// Group the queue by target, damage type and instigator, so the entries of every aggregated hit are contiguous.
+	ResolvingDamage.Sort([](const FChaosPendingDamage& A, const FChaosPendingDamage& B)
+	{
+		if (A.Target != B.Target)
+		{
+			return A.Target < B.Target;
+		}
+		if (A.DamageTypeClass != B.DamageTypeClass)
+		{
+			return A.DamageTypeClass.Get() < B.DamageTypeClass.Get();
+		}
+		return A.Instigator < B.Instigator;
+	});
+
+	const int32 NumEntries = ResolvingDamage.Num();
+	int32 Index = 0;
+	while (Index < NumEntries)
+	{
+		const FChaosPendingDamage& First = ResolvingDamage[Index];
+		float TotalDamage = 0.f;
+		int32 StrongestIndex = Index;
+
+		// Every entry is a separate hit; callers make sure one swing or shot only queues a target once.
+		for (; Index < NumEntries; ++Index)
+		{
+			const FChaosPendingDamage& Entry = ResolvingDamage[Index];
+			if (Entry.Target != First.Target || Entry.DamageTypeClass != First.DamageTypeClass || Entry.Instigator != First.Instigator)
+			{
+				break;
+			}
+
+			TotalDamage += Entry.Amount;
+			if (Entry.Amount > ResolvingDamage[StrongestIndex].Amount)
+			{
+				StrongestIndex = Index;
+			}
+		}
+
+		// Instigator and damage type are shared by the whole group; the strongest causer is reported as its causer.
+		const FChaosPendingDamage& Strongest = ResolvingDamage[StrongestIndex];
+		AActor* Target = Strongest.Target.ResolveObjectPtr();
+		if (IsValid(Target))
+		{
+			UGameplayStatics::ApplyDamage(Target, TotalDamage, Strongest.Instigator.ResolveObjectPtr(), Strongest.Causer.ResolveObjectPtr(), Strongest.DamageTypeClass);
+		}
+	}
+
+	ResolvingDamage.Reset();
+}
+
+void UChaosDamageSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	ResolvePendingDamage();
+}
+
+TStatId UChaosDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosDamageSubsystem, STATGROUP_Tickables);
+}
+
+bool UChaosDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
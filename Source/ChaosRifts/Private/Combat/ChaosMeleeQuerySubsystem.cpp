@@ -0,0 +1,86 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Combat/ChaosMeleeQuerySubsystem.h"
+#include "Combat/ChaosDamageSubsystem.h"
+#include "Characters/Base/ChaosCharacterBase.h"
+#include "Core/ChaosCombatTrace.h"
+#include "GameFramework/Controller.h"
+
+void UChaosMeleeQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UChaosMeleeQuerySubsystem::HandleWorldPreActorTick);
+}
+
+void UChaosMeleeQuerySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	PendingSweeps.Reset();
+
+	Super::Deinitialize();
+}
+
+void UChaosMeleeQuerySubsystem::SubmitMeleeSweep(AChaosCharacterBase* Attacker, const FVector& Start, const FVector& End, float Radius, float Damage, TSubclassOf<UDamageType> DamageTypeClass)
+{
+	if (!IsValid(Attacker))
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosMeleeSweep), false, Attacker);
+
+	FPendingSweep& Sweep = PendingSweeps.AddDefaulted_GetRef();
+	Sweep.Handle = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Multi, Start, End, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeSphere(Radius), QueryParams);
+	Sweep.Attacker = Attacker;
+	Sweep.Instigator = Attacker->GetController();
+	Sweep.DamageTypeClass = DamageTypeClass;
+	Sweep.Damage = Damage;
+}
+
+bool UChaosMeleeQuerySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosMeleeQuerySubsystem::HandleWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || PendingSweeps.IsEmpty())
+	{
+		return;
+	}
+
+	// The world has just swapped its async trace buffers, so last frame's sweeps are all available now.
+	// Attacks submitted while the damage is applied go into the next batch.
+	TArray<FPendingSweep> CompletedSweeps = MoveTemp(PendingSweeps);
+	PendingSweeps.Reset();
+
+	TArray<AChaosCharacterBase*, TInlineAllocator<8>> HitCharacters;
+	for (const FPendingSweep& Sweep : CompletedSweeps)
+	{
+		// An attacker that is gone, back in its pool or died in the frame it attacked does not deal damage anymore.
+		// Corpses stay unpooled for a while, so being dead has to be checked on its own.
+		AChaosCharacterBase* Attacker = Sweep.Attacker.Get();
+		FTraceDatum TraceData;
+		if (!Attacker || Attacker->IsPooled() || Attacker->IsDead() || !World->QueryTraceData(Sweep.Handle, TraceData))
+		{
+			continue;
+		}
+
+		HitCharacters.Reset();
+		for (const FHitResult& Hit : TraceData.OutHits)
+		{
+			AChaosCharacterBase* HitCharacter = Cast<AChaosCharacterBase>(Hit.GetActor());
+			if (HitCharacter && HitCharacter != Attacker)
+			{
+				HitCharacters.AddUnique(HitCharacter);
+			}
+		}
+
+		for (AChaosCharacterBase* HitCharacter : HitCharacters)
+		{
+			UChaosDamageSubsystem::QueueDamage(HitCharacter, Sweep.Damage, Sweep.Instigator.Get(), Attacker, Sweep.DamageTypeClass);
+			FChaosCombatTrace::Record(EChaosCombatEvent::MeleeHit, Attacker, HitCharacter, Sweep.Damage);
+		}
+	}
+}
@@ -0,0 +1,248 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Combat/ChaosProjectileSubsystem.h"
+#include "Combat/ChaosDamageSubsystem.h"
+#include "Core/ChaosCombatTrace.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+
+namespace ChaosProjectiles
+{
+	/** The object types projectiles collide with. */
+	static FCollisionObjectQueryParams MakeObjectQueryParams()
+	{
+		FCollisionObjectQueryParams ObjectParams;
+		ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+		ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+		ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+		ObjectParams.AddObjectTypesToQuery(ECC_Destructible);
+		return ObjectParams;
+	}
+}
+
+void UChaosProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UChaosProjectileSubsystem::HandleWorldPreActorTick);
+}
+
+void UChaosProjectileSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	// The visual actors belong to the world and are torn down with it.
+	Locations.Reset();
+	Velocities.Reset();
+	GravityScales.Reset();
+	Radii.Reset();
+	RemainingLifetimes.Reset();
+	Damages.Reset();
+	Owners.Reset();
+	Instigators.Reset();
+	Visuals.Reset();
+	SweepEnds.Reset();
+	SweepHandles.Reset();
+	DamageTypeClasses.Reset();
+	VisualPools.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UChaosProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UChaosProjectileSubsystem::FireProjectile(const FChaosProjectileSpec& Spec, const FVector& Location, const FVector& Direction, AActor* Owner)
+{
+	if (Locations.Num() >= MaxProjectiles || Spec.Lifetime <= 0.f)
+	{
+		return false;
+	}
+
+	const FVector Velocity = Direction.GetSafeNormal() * Spec.Speed;
+	const APawn* OwnerPawn = Cast<APawn>(Owner);
+
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	GravityScales.Add(Spec.GravityScale);
+	Radii.Add(Spec.Radius);
+	RemainingLifetimes.Add(Spec.Lifetime);
+	Damages.Add(Spec.Damage);
+	Owners.Add(Owner);
+	Instigators.Add(OwnerPawn ? OwnerPawn->GetController() : (Owner ? Owner->GetInstigatorController() : nullptr));
+	Visuals.Add(Spec.VisualClass ? AcquireVisual(Spec.VisualClass, Location, Velocity.Rotation()) : nullptr);
+	SweepEnds.Add(Location);
+	SweepHandles.AddDefaulted();
+	DamageTypeClasses.Add(Spec.DamageTypeClass);
+	return true;
+}
+
+void UChaosProjectileSubsystem::HandleWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || Locations.IsEmpty())
+	{
+		return;
+	}
+
+	ResolveSweeps();
+	SimulateProjectiles(DeltaSeconds);
+	UpdateVisuals();
+}
+
+void UChaosProjectileSubsystem::ResolveSweeps()
+{
+	UWorld* World = GetWorld();
+
+	// Iterate backwards, so removing a projectile only moves one that was already resolved into its slot.
+	for (int32 Index = Locations.Num() - 1; Index >= 0; --Index)
+	{
+		// The world has just swapped its async trace buffers, so last frame's sweeps are all available now.
+		// A projectile whose sweep is missing stays where it is and sweeps again from there.
+		FTraceDatum TraceData;
+		if (!SweepHandles[Index].IsValid() || !World->QueryTraceData(SweepHandles[Index], TraceData))
+		{
+			continue;
+		}
+
+		if (TraceData.OutHits.IsEmpty())
+		{
+			Locations[Index] = SweepEnds[Index];
+			continue;
+		}
+
+		// Every projectile is a hit of its own; the damage subsystem sums all hits a target takes in a frame.
+		AActor* HitActor = TraceData.OutHits[0].GetActor();
+		if (HitActor && HitActor->CanBeDamaged())
+		{
+			AActor* Owner = Owners[Index].Get();
+			UChaosDamageSubsystem::QueueDamage(HitActor, Damages[Index], Instigators[Index].Get(), Owner, DamageTypeClasses[Index]);
+			FChaosCombatTrace::Record(EChaosCombatEvent::ProjectileHit, Owner, HitActor, Damages[Index]);
+		}
+
+		RemoveProjectile(Index);
+	}
+}
+
+void UChaosProjectileSubsystem::SimulateProjectiles(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	const float GravityZ = World->GetGravityZ();
+
+	// Expire first, so the arrays are only compacted once before the integration pass.
+	for (int32 Index = RemainingLifetimes.Num() - 1; Index >= 0; --Index)
+	{
+		RemainingLifetimes[Index] -= DeltaTime;
+		if (RemainingLifetimes[Index] <= 0.f)
+		{
+			RemoveProjectile(Index);
+		}
+	}
+
+	const int32 NumProjectiles = Locations.Num();
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		Velocities[Index].Z += GravityZ * GravityScales[Index] * DeltaTime;
+		SweepEnds[Index] = Locations[Index] + Velocities[Index] * DeltaTime;
+	}
+
+	// All sweeps of the frame are handed to the physics scene together and traced in parallel with the rest of it.
+	static const FCollisionObjectQueryParams ObjectParams = ChaosProjectiles::MakeObjectQueryParams();
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosProjectileSweep), false, Owners[Index].Get());
+		SweepHandles[Index] = World->AsyncSweepByObjectType(
+			EAsyncTraceType::Single,
+			Locations[Index],
+			SweepEnds[Index],
+			FQuat::Identity,
+			ObjectParams,
+			FCollisionShape::MakeSphere(Radii[Index]),
+			QueryParams
+		);
+	}
+}
+
+void UChaosProjectileSubsystem::UpdateVisuals()
+{
+	const int32 NumProjectiles = Locations.Num();
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		if (AActor* Visual = Visuals[Index].Get())
+		{
+			Visual->SetActorLocationAndRotation(Locations[Index], Velocities[Index].Rotation());
+		}
+	}
+}
+
+void UChaosProjectileSubsystem::RemoveProjectile(int32 ProjectileIndex)
+{
+	if (AActor* Visual = Visuals[ProjectileIndex].Get())
+	{
+		ReleaseVisual(Visual);
+	}
+
+	Locations.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	GravityScales.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Radii.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	RemainingLifetimes.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Damages.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Owners.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	Visuals.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	SweepEnds.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	SweepHandles.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+	DamageTypeClasses.RemoveAtSwap(ProjectileIndex, EAllowShrinking::No);
+}
+
+AActor* UChaosProjectileSubsystem::AcquireVisual(TSubclassOf<AActor> VisualClass, const FVector& Location, const FRotator& Rotation)
+{
+	if (TArray<TWeakObjectPtr<AActor>>* Pool = VisualPools.Find(VisualClass.Get()))
+	{
+		while (!Pool->IsEmpty())
+		{
+			if (AActor* Visual = Pool->Pop(EAllowShrinking::No).Get())
+			{
+				Visual->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+				Visual->SetActorHiddenInGame(false);
+				return Visual;
+			}
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Visual = GetWorld()->SpawnActor<AActor>(VisualClass, Location, Rotation, SpawnParams);
+	if (!Visual)
+	{
+		return nullptr;
+	}
+
+	// The record is the projectile; the visual only shows it and must neither collide nor move on its own.
+	Visual->SetActorEnableCollision(false);
+	TInlineComponentArray<UMovementComponent*> MovementComponents(Visual);
+	for (UMovementComponent* MovementComponent : MovementComponents)
+	{
+		MovementComponent->Deactivate();
+	}
+
+	return Visual;
+}
+
+void UChaosProjectileSubsystem::ReleaseVisual(AActor* Visual)
+{
+	TArray<TWeakObjectPtr<AActor>>& Pool = VisualPools.FindOrAdd(Visual->GetClass());
+	if (Pool.Num() >= MaxPooledVisualsPerClass)
+	{
+		Visual->Destroy();
+		return;
+	}
+
+	Visual->SetActorHiddenInGame(true);
+	Pool.Add(Visual);
+}
@@ -0,0 +1,153 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Combat/ChaosRagdollBudgetSubsystem.h"
+#include "Characters/Base/ChaosCharacterBase.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+void UChaosRagdollBudgetSubsystem::RequestRagdoll(AChaosCharacterBase* Character)
+{
+	if (!IsValid(Character) || !Character->GetMesh())
+	{
+		return;
+	}
+
+	if (SimulatedRagdolls.Num() >= MaxSimulatedRagdolls)
+	{
+		// The budget is full. Only a ragdoll that is already at rest can be frozen without leaving it hanging in the
+		// air, so the new corpse takes the slot of the farthest resting ragdoll that is farther away than itself.
+		const FVector ViewLocation = GetViewLocation();
+		int32 FarthestIndex = INDEX_NONE;
+		double FarthestDistanceSquared = FVector::DistSquared(Character->GetActorLocation(), ViewLocation);
+		for (int32 Index = 0; Index < SimulatedRagdolls.Num(); ++Index)
+		{
+			const FSimulatedRagdoll& Ragdoll = SimulatedRagdolls[Index];
+			const AChaosCharacterBase* Simulated = Ragdoll.Character.Get();
+			if (Simulated && Ragdoll.TimeAtRest <= 0.f)
+			{
+				continue;
+			}
+
+			const double DistanceSquared = Simulated ? FVector::DistSquared(Simulated->GetMesh()->GetComponentLocation(), ViewLocation) : TNumericLimits<double>::Max();
+			if (DistanceSquared > FarthestDistanceSquared)
+			{
+				FarthestIndex = Index;
+				FarthestDistanceSquared = DistanceSquared;
+			}
+		}
+
+		// Without such a ragdoll, every slot holds a body that is still falling; the new corpse lies down instead.
+		if (FarthestIndex == INDEX_NONE)
+		{
+			FreezeInDeathPose(Character);
+			return;
+		}
+
+		if (AChaosCharacterBase* Farthest = SimulatedRagdolls[FarthestIndex].Character.Get())
+		{
+			FreezePose(Farthest);
+		}
+		SimulatedRagdolls.RemoveAtSwap(FarthestIndex, 1, EAllowShrinking::No);
+	}
+
+	FSimulatedRagdoll& Ragdoll = SimulatedRagdolls.AddDefaulted_GetRef();
+	Ragdoll.Character = Character;
+	StartRagdoll(Character);
+}
+
+void UChaosRagdollBudgetSubsystem::CancelRagdoll(AChaosCharacterBase* Character)
+{
+	SimulatedRagdolls.RemoveAllSwap([Character](const FSimulatedRagdoll& Ragdoll) { return Ragdoll.Character.Get() == Character; }, EAllowShrinking::No);
+}
+
+void UChaosRagdollBudgetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float SettledSpeedSquared = FMath::Square(SettledSpeed);
+
+	// Iterate backwards so finished ragdolls can be swap-removed in place.
+	for (int32 Index = SimulatedRagdolls.Num() - 1; Index >= 0; --Index)
+	{
+		FSimulatedRagdoll& Ragdoll = SimulatedRagdolls[Index];
+		AChaosCharacterBase* Character = Ragdoll.Character.Get();
+		if (!Character)
+		{
+			SimulatedRagdolls.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		Ragdoll.SimulatedTime += DeltaTime;
+		const bool bAtRest = Character->GetMesh()->GetPhysicsLinearVelocity().SizeSquared() <= SettledSpeedSquared;
+		Ragdoll.TimeAtRest = bAtRest ? Ragdoll.TimeAtRest + DeltaTime : 0.f;
+
+		if (Ragdoll.TimeAtRest >= SettledTime || Ragdoll.SimulatedTime >= MaxSimulationTime)
+		{
+			FreezePose(Character);
+			SimulatedRagdolls.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+TStatId UChaosRagdollBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosRagdollBudgetSubsystem, STATGROUP_Tickables);
+}
+
+bool UChaosRagdollBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosRagdollBudgetSubsystem::StartRagdoll(AChaosCharacterBase* Character)
+{
+	Character->GetMesh()->SetSimulatePhysics(true);
+}
+
+void UChaosRagdollBudgetSubsystem::FreezePose(AChaosCharacterBase* Character)
+{
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	// Stop refreshing the skeleton first, otherwise turning physics off snaps the bones back to the animation pose.
+	Mesh->bNoSkeletonUpdate = true;
+	Mesh->bPauseAnims = true;
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Mesh->SetComponentTickEnabled(false);
+}
+
+void UChaosRagdollBudgetSubsystem::FreezeInDeathPose(AChaosCharacterBase* Character)
+{
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	if (UAnimSequenceBase* DeathPose = Character->GetDeathPose())
+	{
+		// Jump to the last frame and evaluate it once on the game thread, so the pose is final before
+		// FreezePose switches the skeleton updates off.
+		Mesh->OverrideAnimationData(DeathPose, false, false, DeathPose->GetPlayLength(), 0.f);
+		Mesh->TickAnimation(0.f, false);
+		Mesh->RefreshBoneTransforms();
+	}
+	else
+	{
+		// Tip the mesh over backwards around its root, which sits at the character's feet.
+		const FQuat ActorRotation = Character->GetActorQuat();
+		const FQuat TipOver = ActorRotation * FRotator(90.f, 0.f, 0.f).Quaternion() * ActorRotation.Inverse();
+		Mesh->SetWorldRotation(TipOver * Mesh->GetComponentQuat());
+	}
+
+	FreezePose(Character);
+}
+
+FVector UChaosRagdollBudgetSubsystem::GetViewLocation() const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		return PlayerController->PlayerCameraManager->GetCameraLocation();
+	}
+	return FVector::ZeroVector;
+}
@@ -0,0 +1,162 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Combat/ChaosTargetIndexSubsystem.h"
+#include "Components/CapsuleComponent.h"
+
+void UChaosTargetIndexSubsystem::RegisterCharacter(AChaosCharacterBase* Character)
+{
+	if (!IsValid(Character) || EntryIndices.Contains(Character))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = Entries.AddDefaulted();
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Character = Character;
+	Entry.Key = Character;
+	Entry.Location = Character->GetActorLocation();
+	Entry.Radius = Character->GetCapsuleComponent() ? Character->GetCapsuleComponent()->GetScaledCapsuleRadius() : 0.f;
+	Entry.Team = Character->GetTeam();
+	Entry.Cell = GetCell(Entry.Location);
+	MaxEntryRadius = FMath::Max(MaxEntryRadius, Entry.Radius);
+
+	EntryIndices.Add(Character, EntryIndex);
+	AddToCell(EntryIndex);
+}
+
+void UChaosTargetIndexSubsystem::UnregisterCharacter(AChaosCharacterBase* Character)
+{
+	if (const int32* EntryIndex = EntryIndices.Find(Character))
+	{
+		RemoveEntry(*EntryIndex);
+	}
+}
+
+void UChaosTargetIndexSubsystem::QueryCharacters(const FVector& Center, float Radius, EChaosTeam IgnoredTeam, TArray<AChaosCharacterBase*>& OutCharacters) const
+{
+	OutCharacters.Reset();
+
+	const float CellRadius = Radius + MaxEntryRadius;
+	const FIntPoint MinCell = GetCell(Center - FVector(CellRadius, CellRadius, 0.f));
+	const FIntPoint MaxCell = GetCell(Center + FVector(CellRadius, CellRadius, 0.f));
+
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+		{
+			const TArray<int32>* CellEntries = Cells.Find(FIntPoint(CellX, CellY));
+			if (!CellEntries)
+			{
+				continue;
+			}
+
+			for (const int32 EntryIndex : *CellEntries)
+			{
+				const FEntry& Entry = Entries[EntryIndex];
+				if (Entry.Team == IgnoredTeam)
+				{
+					continue;
+				}
+				if (FVector::DistSquared2D(Center, Entry.Location) > FMath::Square(Radius + Entry.Radius))
+				{
+					continue;
+				}
+				if (AChaosCharacterBase* Character = Entry.Character.Get())
+				{
+					OutCharacters.Add(Character);
+				}
+			}
+		}
+	}
+}
+
+void UChaosTargetIndexSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Iterate backwards so stale entries can be swap-removed in place.
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		const AChaosCharacterBase* Character = Entries[EntryIndex].Character.Get();
+		if (!Character)
+		{
+			RemoveEntry(EntryIndex);
+			continue;
+		}
+
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.Location = Character->GetActorLocation();
+
+		// Only characters that crossed a cell boundary are moved between cells.
+		const FIntPoint NewCell = GetCell(Entry.Location);
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(EntryIndex);
+			Entry.Cell = NewCell;
+			AddToCell(EntryIndex);
+		}
+	}
+}
+
+TStatId UChaosTargetIndexSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosTargetIndexSubsystem, STATGROUP_Tickables);
+}
+
+bool UChaosTargetIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FIntPoint UChaosTargetIndexSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UChaosTargetIndexSubsystem::AddToCell(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.IndexInCell = Cells.FindOrAdd(Entry.Cell).Add(EntryIndex);
+}
+
+void UChaosTargetIndexSubsystem::RemoveFromCell(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	TArray<int32>* CellEntries = Cells.Find(Entry.Cell);
+	if (!CellEntries || !CellEntries->IsValidIndex(Entry.IndexInCell))
+	{
+		return;
+	}
+
+	CellEntries->RemoveAtSwap(Entry.IndexInCell, 1, EAllowShrinking::No);
+	if (CellEntries->IsValidIndex(Entry.IndexInCell))
+	{
+		// Another entry was swapped into the freed slot, patch its back-reference.
+		Entries[(*CellEntries)[Entry.IndexInCell]].IndexInCell = Entry.IndexInCell;
+	}
+	else if (CellEntries->Num() == 0)
+	{
+		Cells.Remove(Entry.Cell);
+	}
+	Entry.IndexInCell = INDEX_NONE;
+}
+
+void UChaosTargetIndexSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	RemoveFromCell(EntryIndex);
+	EntryIndices.Remove(Entries[EntryIndex].Key);
+
+	const int32 LastIndex = Entries.Num() - 1;
+	if (EntryIndex != LastIndex)
+	{
+		// Move the last entry into the freed slot and patch the references to it.
+		Entries[EntryIndex] = MoveTemp(Entries[LastIndex]);
+		const FEntry& MovedEntry = Entries[EntryIndex];
+		if (TArray<int32>* CellEntries = Cells.Find(MovedEntry.Cell))
+		{
+			(*CellEntries)[MovedEntry.IndexInCell] = EntryIndex;
+		}
+		EntryIndices.Add(MovedEntry.Key, EntryIndex);
+	}
+	Entries.RemoveAt(LastIndex, 1, EAllowShrinking::No);
+}
@@ -1,6 +1,9 @@
 // Copyright Robinator Studios, Inc. All Rights Reserved.
 
 #include "Components/ChaosAttributes.h"
+#include "Core/ChaosCombatTrace.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 
 UChaosAttributes::UChaosAttributes()
 {
@@ -17,45 +20,366 @@ void UChaosAttributes::BeginPlay()
 	Health = MaxHealth;
 	Chaos = MaxChaos;
 	HealCharges = MaxHealCharges;
+	ChaosTimestamp = GetTimeSeconds();
+	HealChargeTimestamp = ChaosTimestamp;
+
+	// Move the values into the world's attribute store, if there is one.
+	AttributeStore = GetWorld()->GetSubsystem<UChaosAttributeSubsystem>();
+	if (AttributeStore)
+	{
+		StoreHandle = AttributeStore->Register(this);
+	}
+
+	ScheduleChaosThreshold();
+	ScheduleHealChargeThreshold();
+}
+
+void UChaosAttributes::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_ChaosFull);
+		World->GetTimerManager().ClearTimer(TimerHandle_HealCharge);
+	}
+	DirtyAttributeMask = 0;
+
+	if (AttributeStore)
+	{
+		AttributeStore->Unregister(StoreHandle);
+		AttributeStore = nullptr;
+		StoreHandle = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float UChaosAttributes::GetChaos() const
+{
+	if (AttributeStore)
+	{
+		return AttributeStore->GetChaos(StoreHandle);
+	}
+	return UChaosAttributeSubsystem::EvaluateLinear(Chaos, ChaosRate, ChaosTimestamp, GetTimeSeconds(), MaxChaos);
+}
+
+int32 UChaosAttributes::GetHealCharges() const
+{
+	if (AttributeStore)
+	{
+		return AttributeStore->GetHealCharges(StoreHandle);
+	}
+	return UChaosAttributeSubsystem::EvaluateCharges(HealCharges, HealChargeRechargeTime, HealChargeTimestamp, GetTimeSeconds(), MaxHealCharges);
 }
 
 void UChaosAttributes::ApplyHealthChange(float Delta)
 {
-	const float OldHealth = Health;
+	float& CurrentHealth = HealthValue();
+	const float OldHealth = CurrentHealth;
 	// Use FMath::Clamp to ensure Health never goes below 0 or above MaxHealth.
-	Health = FMath::Clamp(Health + Delta, 0.0f, MaxHealth);
-	
-	if (OldHealth != Health)
+	CurrentHealth = FMath::Clamp(CurrentHealth + Delta, 0.0f, GetMaxHealth());
+	const float NewHealth = CurrentHealth;
+
+	if (OldHealth != NewHealth)
 	{
-		// Log the change for debugging purposes.
-		UE_LOG(LogTemp, Log, TEXT("Actor '%s' health changed from %f to %f (Delta: %f)"), *GetOwner()->GetName(), OldHealth, Health, Delta);
+		MarkAttributeDirty(EChaosAttribute::Health, OldHealth);
 
-		if (Health == 0.0f)
+		// Trace the change for debugging purposes. Binary and allocation-free, unlike a log line per hit.
+		FChaosCombatTrace::Record(EChaosCombatEvent::HealthChanged, GetOwner(), nullptr, OldHealth, NewHealth, Delta);
+
+		if (NewHealth == 0.0f)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Actor '%s' has died!"), *GetOwner()->GetName());
-			// In the future, a delegate (OnHealthDepleted) would be broadcast here.
+			HandleHealthDepleted();
 		}
 	}
 }
 
 void UChaosAttributes::ApplyChaosChange(float Delta)
 {
-	const float OldChaos = Chaos;
-	Chaos = FMath::Clamp(Chaos + Delta, 0.0f, MaxChaos);
-	
-	if (OldChaos != Chaos)
+	// The regenerated amount becomes the new base value before the delta is applied on top.
+	MaterializeChaos();
+
+	float& CurrentChaos = ChaosValue();
+	const float OldChaos = CurrentChaos;
+	CurrentChaos = FMath::Clamp(CurrentChaos + Delta, 0.0f, GetMaxChaos());
+
+	if (OldChaos != CurrentChaos)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Actor '%s' chaos changed from %f to %f (Delta: %f)"), *GetOwner()->GetName(), OldChaos, Chaos, Delta);
+		MarkAttributeDirty(EChaosAttribute::Chaos, OldChaos);
+		FChaosCombatTrace::Record(EChaosCombatEvent::ChaosChanged, GetOwner(), nullptr, OldChaos, CurrentChaos, Delta);
 	}
+
+	ScheduleChaosThreshold();
 }
 
 void UChaosAttributes::ApplyHealChargeChange(int32 Delta)
 {
-	const int32 OldCharges = HealCharges;
-	HealCharges = FMath::Clamp(HealCharges + Delta, 0, MaxHealCharges);
+	MaterializeHealCharges();
+
+	int32& CurrentCharges = HealChargesValue();
+	const int32 OldCharges = CurrentCharges;
+	CurrentCharges = FMath::Clamp(CurrentCharges + Delta, 0, GetMaxHealCharges());
+
+	if (OldCharges != CurrentCharges)
+	{
+		MarkAttributeDirty(EChaosAttribute::HealCharges, OldCharges);
+		FChaosCombatTrace::Record(EChaosCombatEvent::HealChargesChanged, GetOwner(), nullptr, OldCharges, CurrentCharges, Delta);
+	}
+
+	ScheduleHealChargeThreshold();
+}
+
+void UChaosAttributes::SetHealthRate(float HealthPerSecond)
+{
+	HealthRate = HealthPerSecond;
+	if (AttributeStore)
+	{
+		AttributeStore->SetHealthRate(StoreHandle, HealthPerSecond);
+	}
+}
+
+void UChaosAttributes::SetChaosRate(float ChaosPerSecond)
+{
+	// Whatever was gained at the old rate is kept; the new rate applies from now on.
+	MaterializeChaos();
+
+	ChaosRate = ChaosPerSecond;
+	if (AttributeStore)
+	{
+		AttributeStore->SetChaosRate(StoreHandle, ChaosPerSecond);
+	}
+
+	ScheduleChaosThreshold();
+}
+
+void UChaosAttributes::SetHealChargeRechargeTime(float SecondsPerCharge)
+{
+	MaterializeHealCharges();
+
+	HealChargeRechargeTime = FMath::Max(SecondsPerCharge, 0.f);
+	if (AttributeStore)
+	{
+		AttributeStore->HealChargeInterval[StoreHandle] = HealChargeRechargeTime;
+	}
+
+	ScheduleHealChargeThreshold();
+}
+
+void UChaosAttributes::SetMaxHealth(float NewMaxHealth)
+{
+	MaxHealth = FMath::Max(NewMaxHealth, 1.f);
+	if (AttributeStore)
+	{
+		AttributeStore->MaxHealth[StoreHandle] = MaxHealth;
+	}
+	ApplyHealthChange(0.f);
+}
+
+void UChaosAttributes::SetMaxChaos(float NewMaxChaos)
+{
+	MaterializeChaos();
+
+	MaxChaos = FMath::Max(NewMaxChaos, 0.f);
+	if (AttributeStore)
+	{
+		AttributeStore->MaxChaos[StoreHandle] = MaxChaos;
+	}
+	ApplyChaosChange(0.f);
+}
+
+void UChaosAttributes::SetMaxHealCharges(int32 NewMaxHealCharges)
+{
+	MaterializeHealCharges();
+
+	MaxHealCharges = FMath::Max(NewMaxHealCharges, 0);
+	if (AttributeStore)
+	{
+		AttributeStore->MaxHealCharges[StoreHandle] = MaxHealCharges;
+	}
+	ApplyHealChargeChange(0);
+}
+
+void UChaosAttributes::ResetAttributes()
+{
+	const UChaosAttributes* Defaults = CastChecked<UChaosAttributes>(GetArchetype());
+	SetMaxHealth(Defaults->MaxHealth);
+	SetMaxChaos(Defaults->MaxChaos);
+	SetMaxHealCharges(Defaults->MaxHealCharges);
+	SetHealthRate(Defaults->HealthRate);
+	SetChaosRate(Defaults->ChaosRate);
+	SetHealChargeRechargeTime(Defaults->HealChargeRechargeTime);
+
+	// Fill everything up through the regular modifiers, so listeners are notified of the changes.
+	ApplyHealthChange(GetMaxHealth());
+	ApplyChaosChange(GetMaxChaos());
+	ApplyHealChargeChange(GetMaxHealCharges());
+}
+
+void UChaosAttributes::HandleHealthDepleted()
+{
+	UE_LOG(LogTemp, Warning, TEXT("Actor '%s' has died!"), *GetOwner()->GetName());
+	OnHealthDepleted.Broadcast(this);
+}
+
+void UChaosAttributes::MaterializeChaos()
+{
+	ChaosValue() = GetChaos();
+	ChaosTimestampValue() = GetTimeSeconds();
+}
+
+void UChaosAttributes::MaterializeHealCharges()
+{
+	const int32 CurrentCharges = GetHealCharges();
+	int32& BaseCharges = HealChargesValue();
+	double& Timestamp = HealChargeTimestampValue();
+
+	if (HealChargeRechargeTime <= 0.f || CurrentCharges >= GetMaxHealCharges())
+	{
+		// Nothing is recharging; a recharge started later begins from now.
+		Timestamp = GetTimeSeconds();
+	}
+	else
+	{
+		// Advance by whole charges only, so the progress on the next charge is kept.
+		Timestamp += static_cast<double>(CurrentCharges - BaseCharges) * HealChargeRechargeTime;
+	}
+	BaseCharges = CurrentCharges;
+}
+
+void UChaosAttributes::ScheduleChaosThreshold()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const float CurrentChaos = GetChaos();
+	const float CurrentMaxChaos = GetMaxChaos();
+	if (ChaosRate <= 0.f || CurrentChaos >= CurrentMaxChaos)
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_ChaosFull);
+		return;
+	}
+
+	const float TimeToFull = (CurrentMaxChaos - CurrentChaos) / ChaosRate;
+	World->GetTimerManager().SetTimer(TimerHandle_ChaosFull, this, &UChaosAttributes::HandleChaosFull, FMath::Max(TimeToFull, KINDA_SMALL_NUMBER), false);
+}
+
+void UChaosAttributes::ScheduleHealChargeThreshold()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	if (HealChargeRechargeTime <= 0.f || GetHealCharges() >= GetMaxHealCharges())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_HealCharge);
+		return;
+	}
+
+	// Only called right after materializing, so the timestamp is the start of the charge in progress.
+	const double TimeToCharge = HealChargeTimestampValue() + HealChargeRechargeTime - GetTimeSeconds();
+	World->GetTimerManager().SetTimer(TimerHandle_HealCharge, this, &UChaosAttributes::HandleHealChargeRecharged, FMath::Max(static_cast<float>(TimeToCharge), KINDA_SMALL_NUMBER), false);
+}
+
+void UChaosAttributes::HandleChaosFull()
+{
+	// Float rounding can leave the evaluated value a hair below the maximum when the timer fires.
+	if (GetChaos() >= GetMaxChaos() - KINDA_SMALL_NUMBER)
+	{
+		OnChaosFull.Broadcast(this);
+	}
+	else
+	{
+		ScheduleChaosThreshold();
+	}
+}
+
+void UChaosAttributes::HandleHealChargeRecharged()
+{
+	// The stored count is still the one from before the recharge.
+	MarkAttributeDirty(EChaosAttribute::HealCharges, HealChargesValue());
+	MaterializeHealCharges();
+	OnHealChargeGained.Broadcast(this, GetHealCharges());
+	ScheduleHealChargeThreshold();
+}
+
+void UChaosAttributes::MarkAttributeDirty(EChaosAttribute Attribute, float OldValue)
+{
+	const uint8 AttributeBit = 1 << static_cast<uint8>(Attribute);
+	if (DirtyAttributeMask & AttributeBit)
+	{
+		return;
+	}
+
+	DirtyOldValues[static_cast<uint8>(Attribute)] = OldValue;
+	const bool bWasClean = DirtyAttributeMask == 0;
+	DirtyAttributeMask |= AttributeBit;
+
+	if (!bWasClean)
+	{
+		return;
+	}
+
+	// The store flushes all dirty components at the end of the frame. Without one, flush on the next tick.
+	if (AttributeStore)
+	{
+		AttributeStore->QueueAttributeFlush(this);
+	}
+	else if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().SetTimerForNextTick(this, &UChaosAttributes::FlushAttributeChanges);
+	}
+}
 
-	if (OldCharges != HealCharges)
+void UChaosAttributes::FlushAttributeChanges()
+{
+	// Clear first, so listeners changing attributes again are reported in the next flush.
+	const uint8 FlushedMask = DirtyAttributeMask;
+	DirtyAttributeMask = 0;
+
+	for (uint8 AttributeIndex = 0; AttributeIndex < static_cast<uint8>(EChaosAttribute::Num); ++AttributeIndex)
+	{
+		if (!(FlushedMask & (1 << AttributeIndex)))
+		{
+			continue;
+		}
+
+		const EChaosAttribute Attribute = static_cast<EChaosAttribute>(AttributeIndex);
+		const float OldValue = DirtyOldValues[AttributeIndex];
+		const float NewValue = GetAttributeValue(Attribute);
+
+		// Changes that cancelled each other out within the frame are not reported.
+		if (OldValue != NewValue)
+		{
+			OnAttributeChanged.Broadcast(this, Attribute, OldValue, NewValue);
+		}
+	}
+}
+
+float UChaosAttributes::GetAttributeValue(EChaosAttribute Attribute) const
+{
+	switch (Attribute)
+	{
+	case EChaosAttribute::Health:
+		return GetHealth();
+	case EChaosAttribute::Chaos:
+		return GetChaos();
+	case EChaosAttribute::HealCharges:
+		return GetHealCharges();
+	default:
+		return 0.f;
+	}
+}
+
+double UChaosAttributes::GetTimeSeconds() const
+{
+	if (AttributeStore)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Actor '%s' heal charges changed from %d to %d (Delta: %d)"), *GetOwner()->GetName(), OldCharges, HealCharges, Delta);
+		return AttributeStore->GetTimeSeconds();
 	}
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
 }
@@ -0,0 +1,265 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Core/ChaosAttributeSubsystem.h"
+#include "Components/ChaosAttributes.h"
+#include "Engine/World.h"
+
+float UChaosAttributeSubsystem::GetChaos(int32 Handle) const
+{
+	return EvaluateLinear(Chaos[Handle], ChaosRate[Handle], ChaosTimestamp[Handle], GetTimeSeconds(), MaxChaos[Handle]);
+}
+
+int32 UChaosAttributeSubsystem::GetHealCharges(int32 Handle) const
+{
+	return EvaluateCharges(HealCharges[Handle], HealChargeInterval[Handle], HealChargeTimestamp[Handle], GetTimeSeconds(), MaxHealCharges[Handle]);
+}
+
+double UChaosAttributeSubsystem::GetTimeSeconds() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+void UChaosAttributeSubsystem::ApplyHealthChangeToAll(float Delta)
+{
+	FrameDeltas.Init(Delta, Health.Num());
+	ApplyFrameDeltasToHealth();
+}
+
+void UChaosAttributeSubsystem::ApplyChaosChangeToAll(float Delta)
+{
+	const int32 NumEntities = Chaos.Num();
+	const double Now = GetTimeSeconds();
+	float* RESTRICT Values = Chaos.GetData();
+	double* RESTRICT Timestamps = ChaosTimestamp.GetData();
+	const float* RESTRICT Rates = ChaosRate.GetData();
+	const float* RESTRICT MaxValues = MaxChaos.GetData();
+
+	// Materialize the lazily evaluated value, apply the delta and restart the evaluation from now.
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		const float CurrentValue = EvaluateLinear(Values[Index], Rates[Index], Timestamps[Index], Now, MaxValues[Index]);
+		Values[Index] = FMath::Clamp(CurrentValue + Delta, 0.f, MaxValues[Index]);
+		Timestamps[Index] = Now;
+		if (Values[Index] != CurrentValue)
+		{
+			if (UChaosAttributes* Attributes = Owners[Index].Get())
+			{
+				Attributes->MarkAttributeDirty(EChaosAttribute::Chaos, CurrentValue);
+			}
+		}
+	}
+
+	// Regenerating entities reach their thresholds at a different time now.
+	if (NumChaosRates > 0)
+	{
+		for (int32 Index = 0; Index < NumEntities; ++Index)
+		{
+			UChaosAttributes* Attributes = Rates[Index] != 0.f ? Owners[Index].Get() : nullptr;
+			if (Attributes)
+			{
+				Attributes->ScheduleChaosThreshold();
+			}
+		}
+	}
+}
+
+void UChaosAttributeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 NumEntities = Owners.Num();
+	if (NumHealthRates > 0)
+	{
+		FrameDeltas.SetNumUninitialized(NumEntities, EAllowShrinking::No);
+		const float* RESTRICT Rates = HealthRate.GetData();
+		float* RESTRICT Deltas = FrameDeltas.GetData();
+		for (int32 Index = 0; Index < NumEntities; ++Index)
+		{
+			Deltas[Index] = Rates[Index] * DeltaTime;
+		}
+		ApplyFrameDeltasToHealth();
+	}
+
+	// Chaos and heal charges are evaluated lazily and need no per-frame work.
+}
+
+void UChaosAttributeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UChaosAttributeSubsystem::HandleWorldPostActorTick);
+}
+
+void UChaosAttributeSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	DirtyAttributes.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UChaosAttributeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosAttributeSubsystem, STATGROUP_Tickables);
+}
+
+bool UChaosAttributeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UChaosAttributeSubsystem::Register(UChaosAttributes* Attributes)
+{
+	check(Attributes);
+
+	const int32 Handle = Owners.Add(Attributes);
+	Health.Add(Attributes->Health);
+	MaxHealth.Add(Attributes->MaxHealth);
+	MaxChaos.Add(Attributes->MaxChaos);
+	MaxHealCharges.Add(Attributes->MaxHealCharges);
+	HealthRate.Add(0.f);
+	Chaos.Add(Attributes->Chaos);
+	ChaosRate.Add(0.f);
+	ChaosTimestamp.Add(Attributes->ChaosTimestamp);
+	HealCharges.Add(Attributes->HealCharges);
+	HealChargeInterval.Add(Attributes->HealChargeRechargeTime);
+	HealChargeTimestamp.Add(Attributes->HealChargeTimestamp);
+
+	SetHealthRate(Handle, Attributes->HealthRate);
+	SetChaosRate(Handle, Attributes->ChaosRate);
+	return Handle;
+}
+
+void UChaosAttributeSubsystem::Unregister(int32 Handle)
+{
+	if (!Owners.IsValidIndex(Handle))
+	{
+		return;
+	}
+
+	// Hand the current values back to the component, so it keeps working without the store.
+	if (UChaosAttributes* Attributes = Owners[Handle].Get())
+	{
+		Attributes->Health = Health[Handle];
+		Attributes->Chaos = Chaos[Handle];
+		Attributes->ChaosTimestamp = ChaosTimestamp[Handle];
+		Attributes->HealCharges = HealCharges[Handle];
+		Attributes->HealChargeTimestamp = HealChargeTimestamp[Handle];
+	}
+
+	SetHealthRate(Handle, 0.f);
+	SetChaosRate(Handle, 0.f);
+
+	Owners.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	Health.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	MaxHealth.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	MaxChaos.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	MaxHealCharges.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	HealthRate.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	Chaos.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	ChaosRate.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	ChaosTimestamp.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	HealCharges.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	HealChargeInterval.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+	HealChargeTimestamp.RemoveAtSwap(Handle, 1, EAllowShrinking::No);
+
+	// The last slot was moved into the freed one; its owner has a new handle now.
+	if (UChaosAttributes* MovedAttributes = Owners.IsValidIndex(Handle) ? Owners[Handle].Get() : nullptr)
+	{
+		MovedAttributes->StoreHandle = Handle;
+	}
+}
+
+void UChaosAttributeSubsystem::SetHealthRate(int32 Handle, float Rate)
+{
+	NumHealthRates += (Rate != 0.f) - (HealthRate[Handle] != 0.f);
+	HealthRate[Handle] = Rate;
+}
+
+void UChaosAttributeSubsystem::SetChaosRate(int32 Handle, float Rate)
+{
+	NumChaosRates += (Rate != 0.f) - (ChaosRate[Handle] != 0.f);
+	ChaosRate[Handle] = Rate;
+}
+
+void UChaosAttributeSubsystem::ApplyFrameDeltasToHealth()
+{
+	const int32 NumEntities = Health.Num();
+	DepletedFlags.SetNumUninitialized(NumEntities, EAllowShrinking::No);
+	PreviousValues.SetNumUninitialized(NumEntities, EAllowShrinking::No);
+
+	float* RESTRICT Values = Health.GetData();
+	const float* RESTRICT MaxValues = MaxHealth.GetData();
+	const float* RESTRICT Deltas = FrameDeltas.GetData();
+	float* RESTRICT OldValues = PreviousValues.GetData();
+	uint8* RESTRICT Flags = DepletedFlags.GetData();
+
+	// Branch-free so the compiler can vectorize it.
+	uint8 AnyDepleted = 0;
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		const float OldValue = Values[Index];
+		const float NewValue = FMath::Clamp(OldValue + Deltas[Index], 0.f, MaxValues[Index]);
+		Values[Index] = NewValue;
+		OldValues[Index] = OldValue;
+		Flags[Index] = (OldValue > 0.f) & (NewValue <= 0.f);
+		AnyDepleted |= Flags[Index];
+	}
+
+	// Marking only touches the components, not the columns, so it can't invalidate the pointers above.
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		UChaosAttributes* Attributes = Values[Index] != OldValues[Index] ? Owners[Index].Get() : nullptr;
+		if (Attributes)
+		{
+			Attributes->MarkAttributeDirty(EChaosAttribute::Health, OldValues[Index]);
+		}
+	}
+
+	if (!AnyDepleted)
+	{
+		return;
+	}
+
+	// Collect first: death reactions may destroy actors, which unregisters them and reorders the arrays.
+	TArray<TWeakObjectPtr<UChaosAttributes>, TInlineAllocator<16>> DepletedAttributes;
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (Flags[Index])
+		{
+			DepletedAttributes.Add(Owners[Index]);
+		}
+	}
+	for (const TWeakObjectPtr<UChaosAttributes>& Attributes : DepletedAttributes)
+	{
+		if (Attributes.IsValid())
+		{
+			Attributes->HandleHealthDepleted();
+		}
+	}
+}
+
+void UChaosAttributeSubsystem::QueueAttributeFlush(UChaosAttributes* Attributes)
+{
+	DirtyAttributes.Add(Attributes);
+}
+
+void UChaosAttributeSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || DirtyAttributes.IsEmpty())
+	{
+		return;
+	}
+
+	// Listeners may change attributes again; those components are queued for the next frame's flush.
+	TArray<TWeakObjectPtr<UChaosAttributes>> AttributesToFlush = MoveTemp(DirtyAttributes);
+	DirtyAttributes.Reset();
+	for (const TWeakObjectPtr<UChaosAttributes>& Attributes : AttributesToFlush)
+	{
+		if (Attributes.IsValid())
+		{
+			Attributes->FlushAttributeChanges();
+		}
+	}
+}
@@ -0,0 +1,366 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Core/ChaosCombatTrace.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogChaosCombatTrace, Log, All);
+
+namespace ChaosCombatTrace
+{
+	static_assert(FMath::IsPowerOfTwo(FChaosCombatTrace::Capacity), "The combat trace capacity must be a power of two.");
+
+	// Identifies combat trace dumps and their layout.
+	static constexpr uint32 FileMagic = 0x43525443; // 'CTRC'
+	static constexpr uint32 FileVersion = 1;
+
+	static bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("Chaos.CombatTrace.Enabled"),
+		bEnabled,
+		TEXT("Records combat events into the binary combat trace ring buffer."));
+
+	static FChaosCombatTraceRecord Records[FChaosCombatTrace::Capacity];
+	static std::atomic<uint64> WriteIndex = 0;
+
+	/** A plain copy of a record, as read from the ring buffer or from a dump. */
+	struct FRecordCopy
+	{
+		uint64 Frame = 0;
+		uint32 SourceId = 0;
+		uint32 TargetId = 0;
+		float Values[3] = {};
+		uint8 Type = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FRecordCopy& Record)
+		{
+			return Ar << Record.Frame << Record.SourceId << Record.TargetId << Record.Values[0] << Record.Values[1] << Record.Values[2] << Record.Type;
+		}
+	};
+
+	/** Visits copies of the records currently in the ring buffer, oldest first. Records being overwritten right now are skipped. */
+	template <typename VisitorType>
+	static void ForEachRecord(VisitorType&& Visit)
+	{
+		const uint64 EndIndex = WriteIndex.load(std::memory_order_acquire);
+		const uint64 StartIndex = EndIndex > FChaosCombatTrace::Capacity ? EndIndex - FChaosCombatTrace::Capacity : 0;
+
+		for (uint64 Index = StartIndex; Index < EndIndex; ++Index)
+		{
+			const FChaosCombatTraceRecord& Record = Records[Index & (FChaosCombatTrace::Capacity - 1)];
+			if (Record.Sequence.load(std::memory_order_acquire) != Index + 1)
+			{
+				continue;
+			}
+
+			FRecordCopy Copy;
+			Copy.Frame = Record.Frame;
+			Copy.SourceId = Record.SourceId;
+			Copy.TargetId = Record.TargetId;
+			FMemory::Memcpy(Copy.Values, Record.Values, sizeof(Copy.Values));
+			Copy.Type = static_cast<uint8>(Record.Type);
+
+			// A writer may have lapped us while copying; the record is only valid if its sequence did not change.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Record.Sequence.load(std::memory_order_relaxed) == Index + 1)
+			{
+				Visit(Copy);
+			}
+		}
+	}
+
+	/** Copies the records currently in the ring buffer, oldest first. */
+	static void Snapshot(TArray<FRecordCopy>& OutRecords)
+	{
+		OutRecords.Reset(static_cast<int32>(FMath::Min<uint64>(WriteIndex.load(std::memory_order_relaxed), FChaosCombatTrace::Capacity)));
+		ForEachRecord([&OutRecords](const FRecordCopy& Copy)
+		{
+			OutRecords.Add(Copy);
+		});
+	}
+
+	/** Returns a readable name for a recorded object ID, resolving it if the object is still alive. */
+	static FString DescribeObject(uint32 ObjectId, bool bResolveNames)
+	{
+		if (ObjectId == 0)
+		{
+			return TEXT("-");
+		}
+
+		if (bResolveNames)
+		{
+			// Object slots are reused, so this is only a hint for dumps from the running session.
+			if (const FUObjectItem* Item = GUObjectArray.IndexToObject(static_cast<int32>(ObjectId)))
+			{
+				if (const UObject* Object = static_cast<UObject*>(Item->GetObject()))
+				{
+					return FString::Printf(TEXT("%s(#%u)"), *Object->GetName(), ObjectId);
+				}
+			}
+		}
+		return FString::Printf(TEXT("#%u"), ObjectId);
+	}
+
+	static void LogRecords(const TArray<FRecordCopy>& RecordCopies, bool bResolveNames)
+	{
+		UE_LOG(LogChaosCombatTrace, Display, TEXT("Combat trace: %d records"), RecordCopies.Num());
+		for (const FRecordCopy& Record : RecordCopies)
+		{
+			const EChaosCombatEvent Type = Record.Type < static_cast<uint8>(EChaosCombatEvent::Num) ? static_cast<EChaosCombatEvent>(Record.Type) : EChaosCombatEvent::Num;
+			UE_LOG(LogChaosCombatTrace, Display, TEXT("[%llu] %s Source=%s Target=%s Values=(%g, %g, %g)"),
+				Record.Frame,
+				LexToString(Type),
+				*DescribeObject(Record.SourceId, bResolveNames),
+				*DescribeObject(Record.TargetId, bResolveNames),
+				Record.Values[0], Record.Values[1], Record.Values[2]);
+		}
+	}
+
+	//~ The crash dump. Everything it needs is set up at startup, so writing it allocates nothing and formats nothing.
+
+	// The byte layout of a dump, matching what DumpToFile serializes: a header of magic, version and record count,
+	// then Frame, SourceId, TargetId, Values and Type of every record, packed.
+	static constexpr SIZE_T DumpHeaderSize = 2 * sizeof(uint32) + sizeof(int32);
+	static constexpr SIZE_T DumpRecordSize = sizeof(uint64) + 2 * sizeof(uint32) + 3 * sizeof(float) + sizeof(uint8);
+
+	static uint8 CrashDumpBuffer[DumpHeaderSize + FChaosCombatTrace::Capacity * DumpRecordSize];
+	static FString CrashDumpFilename;
+	static IFileHandle* CrashDumpFile = nullptr;
+	static std::atomic<bool> bCrashDumpWritten = false;
+
+	static void WriteBytes(uint8*& Cursor, const void* Data, SIZE_T Size)
+	{
+		FMemory::Memcpy(Cursor, Data, Size);
+		Cursor += Size;
+	}
+
+	/** Writes the ring buffer to the file opened at startup. Runs while the process is in an error state. */
+	static void HandleSystemError()
+	{
+		if (!CrashDumpFile || bCrashDumpWritten.exchange(true))
+		{
+			return;
+		}
+
+		uint8* Cursor = CrashDumpBuffer + DumpHeaderSize;
+		int32 NumRecords = 0;
+		ForEachRecord([&Cursor, &NumRecords](const FRecordCopy& Record)
+		{
+			WriteBytes(Cursor, &Record.Frame, sizeof(Record.Frame));
+			WriteBytes(Cursor, &Record.SourceId, sizeof(Record.SourceId));
+			WriteBytes(Cursor, &Record.TargetId, sizeof(Record.TargetId));
+			WriteBytes(Cursor, Record.Values, sizeof(Record.Values));
+			WriteBytes(Cursor, &Record.Type, sizeof(Record.Type));
+			++NumRecords;
+		});
+
+		uint8* HeaderCursor = CrashDumpBuffer;
+		WriteBytes(HeaderCursor, &FileMagic, sizeof(FileMagic));
+		WriteBytes(HeaderCursor, &FileVersion, sizeof(FileVersion));
+		WriteBytes(HeaderCursor, &NumRecords, sizeof(NumRecords));
+
+		CrashDumpFile->Seek(0);
+		CrashDumpFile->Write(CrashDumpBuffer, Cursor - CrashDumpBuffer);
+		CrashDumpFile->Flush();
+		FPlatformMisc::LowLevelOutputDebugString(TEXT("Combat trace dumped to Saved/CombatTrace.\n"));
+	}
+
+	/** Closes the crash dump file on a clean exit and deletes it unless a dump was written into it. */
+	static void CloseCrashDumpFile()
+	{
+		if (!CrashDumpFile)
+		{
+			return;
+		}
+
+		delete CrashDumpFile;
+		CrashDumpFile = nullptr;
+		if (!bCrashDumpWritten)
+		{
+			FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*CrashDumpFilename);
+		}
+	}
+
+	/** Opens the crash dump file once the first game or PIE world comes up. Editor-only worlds do not need one. */
+	static void HandlePostWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS)
+	{
+		if (CrashDumpFile || !World || (World->WorldType != EWorldType::Game && World->WorldType != EWorldType::PIE))
+		{
+			return;
+		}
+
+		// The file is opened up front, since opening it needs the heap. One file per process, so sessions running
+		// side by side do not write into each other's dumps.
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		const FString Directory = FPaths::ProjectSavedDir() / TEXT("CombatTrace");
+		CrashDumpFilename = Directory / FString::Printf(TEXT("CombatTrace-Crash-%u.bin"), FPlatformProcess::GetCurrentProcessId());
+		PlatformFile.CreateDirectoryTree(*Directory);
+		CrashDumpFile = PlatformFile.OpenWrite(*CrashDumpFilename);
+	}
+
+	static FDelayedAutoRegisterHelper RegisterCrashDump(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+	{
+		// Commandlets (e.g. the ledge bake) and dedicated servers do not record combat for players to report.
+		if (IsRunningCommandlet() || IsRunningDedicatedServer())
+		{
+			return;
+		}
+
+		FWorldDelegates::OnPostWorldInitialization.AddStatic(&HandlePostWorldInitialization);
+		FCoreDelegates::OnHandleSystemError.AddStatic(&HandleSystemError);
+		FCoreDelegates::OnExit.AddStatic(&CloseCrashDumpFile);
+	});
+
+	static FAutoConsoleCommand DumpCommand(
+		TEXT("Chaos.CombatTrace.Dump"),
+		TEXT("Writes the combat trace to a binary file. Usage: Chaos.CombatTrace.Dump [Filename]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Filename = FChaosCombatTrace::DumpToFile(Args.IsValidIndex(0) ? Args[0] : FString());
+			if (Filename.IsEmpty())
+			{
+				UE_LOG(LogChaosCombatTrace, Warning, TEXT("Failed to write the combat trace."));
+			}
+			else
+			{
+				UE_LOG(LogChaosCombatTrace, Display, TEXT("Combat trace written to %s"), *Filename);
+			}
+		}));
+
+	static FAutoConsoleCommand DecodeCommand(
+		TEXT("Chaos.CombatTrace.Decode"),
+		TEXT("Logs the combat trace in readable form. Usage: Chaos.CombatTrace.Decode [Filename] (no filename decodes the live buffer)"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.IsValidIndex(0))
+			{
+				FChaosCombatTrace::DecodeFile(Args[0]);
+			}
+			else
+			{
+				FChaosCombatTrace::DecodeLive();
+			}
+		}));
+}
+
+void FChaosCombatTrace::Record(EChaosCombatEvent Type, const UObject* Source, const UObject* Target, float Value0, float Value1, float Value2)
+{
+	if (!ChaosCombatTrace::bEnabled)
+	{
+		return;
+	}
+
+	const uint64 Index = ChaosCombatTrace::WriteIndex.fetch_add(1, std::memory_order_relaxed);
+	FChaosCombatTraceRecord& Record = ChaosCombatTrace::Records[Index & (Capacity - 1)];
+
+	// Invalidate the slot while it is being written, so readers skip it instead of reading a torn record.
+	Record.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Record.Frame = GFrameCounter;
+	Record.SourceId = Source ? Source->GetUniqueID() : 0;
+	Record.TargetId = Target ? Target->GetUniqueID() : 0;
+	Record.Values[0] = Value0;
+	Record.Values[1] = Value1;
+	Record.Values[2] = Value2;
+	Record.Type = Type;
+
+	Record.Sequence.store(Index + 1, std::memory_order_release);
+}
+
+FString FChaosCombatTrace::DumpToFile(const FString& Filename)
+{
+	const FString OutputFilename = Filename.IsEmpty()
+		? FPaths::ProjectSavedDir() / TEXT("CombatTrace") / FString::Printf(TEXT("CombatTrace-%s.bin"), *FDateTime::Now().ToString())
+		: Filename;
+
+	TArray<ChaosCombatTrace::FRecordCopy> RecordCopies;
+	ChaosCombatTrace::Snapshot(RecordCopies);
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutputFilename));
+	if (!Writer)
+	{
+		return FString();
+	}
+
+	uint32 Magic = ChaosCombatTrace::FileMagic;
+	uint32 Version = ChaosCombatTrace::FileVersion;
+	int32 NumRecords = RecordCopies.Num();
+	*Writer << Magic << Version << NumRecords;
+	for (ChaosCombatTrace::FRecordCopy& Record : RecordCopies)
+	{
+		*Writer << Record;
+	}
+
+	return Writer->Close() ? OutputFilename : FString();
+}
+
+bool FChaosCombatTrace::DecodeFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader)
+	{
+		UE_LOG(LogChaosCombatTrace, Warning, TEXT("Could not open combat trace '%s'."), *Filename);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 NumRecords = 0;
+	*Reader << Magic << Version << NumRecords;
+	if (Magic != ChaosCombatTrace::FileMagic || Version != ChaosCombatTrace::FileVersion || NumRecords < 0 || NumRecords > static_cast<int32>(Capacity))
+	{
+		UE_LOG(LogChaosCombatTrace, Warning, TEXT("'%s' is not a combat trace of version %u."), *Filename, ChaosCombatTrace::FileVersion);
+		return false;
+	}
+
+	TArray<ChaosCombatTrace::FRecordCopy> RecordCopies;
+	RecordCopies.SetNum(NumRecords);
+	for (ChaosCombatTrace::FRecordCopy& Record : RecordCopies)
+	{
+		*Reader << Record;
+	}
+
+	// Object IDs from another session would resolve to unrelated objects.
+	ChaosCombatTrace::LogRecords(RecordCopies, false);
+	return !Reader->IsError();
+}
+
+void FChaosCombatTrace::DecodeLive()
+{
+	TArray<ChaosCombatTrace::FRecordCopy> RecordCopies;
+	ChaosCombatTrace::Snapshot(RecordCopies);
+	ChaosCombatTrace::LogRecords(RecordCopies, true);
+}
+
+const TCHAR* LexToString(EChaosCombatEvent Type)
+{
+	switch (Type)
+	{
+	case EChaosCombatEvent::HealthChanged:
+		return TEXT("HealthChanged(Old, New, Delta)");
+	case EChaosCombatEvent::ChaosChanged:
+		return TEXT("ChaosChanged(Old, New, Delta)");
+	case EChaosCombatEvent::HealChargesChanged:
+		return TEXT("HealChargesChanged(Old, New, Delta)");
+	case EChaosCombatEvent::WeaponHitDetectionEnabled:
+		return TEXT("WeaponHitDetectionEnabled(SwingId)");
+	case EChaosCombatEvent::WeaponHitDetectionDisabled:
+		return TEXT("WeaponHitDetectionDisabled(SwingId)");
+	case EChaosCombatEvent::MeleeHit:
+		return TEXT("MeleeHit(Damage)");
+	case EChaosCombatEvent::ProjectileHit:
+		return TEXT("ProjectileHit(Damage)");
+	case EChaosCombatEvent::PelletHit:
+		return TEXT("PelletHit(Damage, NumPellets)");
+	default:
+		return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,222 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Core/ChaosCooldownSubsystem.h"
+#include "Engine/World.h"
+
+void UChaosCooldownSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int32& SlotHead : SlotHeads)
+	{
+		SlotHead = INDEX_NONE;
+	}
+}
+
+void UChaosCooldownSubsystem::StartCooldown(const UObject* Owner, FName CooldownId, float Duration, FSimpleDelegate OnExpired)
+{
+	if (!Owner)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (ActiveCooldowns.IsEmpty())
+	{
+		// Tick skips over time while the wheel is empty; catch up before placing the first entry.
+		NextTick = FMath::Max(NextTick, FMath::FloorToInt64(Now / TickResolution) + 1);
+	}
+
+	const FCooldownKey Key{ Owner, CooldownId };
+	int32 EntryIndex = INDEX_NONE;
+	if (const int32* ExistingIndex = ActiveCooldowns.Find(Key))
+	{
+		EntryIndex = *ExistingIndex;
+		UnlinkEntry(EntryIndex);
+	}
+	else
+	{
+		EntryIndex = FreeEntries.IsEmpty() ? Entries.AddDefaulted() : FreeEntries.Pop(EAllowShrinking::No);
+		Entries[EntryIndex].Key = Key;
+		ActiveCooldowns.Add(Key, EntryIndex);
+	}
+
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.OnExpired = MoveTemp(OnExpired);
+	Entry.ExpireTime = Now + FMath::Max(Duration, 0.f);
+	Entry.ExpireTick = TimeToTick(Entry.ExpireTime);
+	LinkEntry(EntryIndex);
+}
+
+void UChaosCooldownSubsystem::CancelCooldown(const UObject* Owner, FName CooldownId)
+{
+	if (const int32* EntryIndex = ActiveCooldowns.Find(FCooldownKey{ Owner, CooldownId }))
+	{
+		RemoveEntry(*EntryIndex);
+	}
+}
+
+void UChaosCooldownSubsystem::CancelAllCooldowns(const UObject* Owner)
+{
+	const TObjectKey<UObject> OwnerKey(Owner);
+	for (auto It = ActiveCooldowns.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Owner == OwnerKey)
+		{
+			const int32 EntryIndex = It.Value();
+			UnlinkEntry(EntryIndex);
+			Entries[EntryIndex].OnExpired.Unbind();
+			FreeEntries.Add(EntryIndex);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UChaosCooldownSubsystem::IsCooldownReady(const UObject* Owner, FName CooldownId) const
+{
+	return GetRemainingCooldown(Owner, CooldownId) <= 0.f;
+}
+
+float UChaosCooldownSubsystem::GetRemainingCooldown(const UObject* Owner, FName CooldownId) const
+{
+	// Compare against the exact expiry time: the wheel may expire an entry up to one tick late, the query never does.
+	const int32* EntryIndex = ActiveCooldowns.Find(FCooldownKey{ Owner, CooldownId });
+	return EntryIndex ? FMath::Max(static_cast<float>(Entries[*EntryIndex].ExpireTime - GetWorld()->GetTimeSeconds()), 0.f) : 0.f;
+}
+
+void UChaosCooldownSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int64 TargetTick = FMath::FloorToInt64(GetWorld()->GetTimeSeconds() / TickResolution);
+	while (NextTick <= TargetTick && !ActiveCooldowns.IsEmpty())
+	{
+		AdvanceTick();
+	}
+
+	if (ActiveCooldowns.IsEmpty())
+	{
+		NextTick = FMath::Max(NextTick, TargetTick + 1);
+	}
+}
+
+TStatId UChaosCooldownSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChaosCooldownSubsystem, STATGROUP_Tickables);
+}
+
+void UChaosCooldownSubsystem::LinkEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+
+	// The level is chosen by how far ahead the entry expires, the slot within the level by the expiry tick itself.
+	const int64 Delta = FMath::Clamp(Entry.ExpireTick - NextTick, int64(0), MaxTickDelta);
+	const int64 SlotTick = NextTick + Delta;
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (int64(1) << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	const int32 Slot = Level * NumSlots + static_cast<int32>((SlotTick >> (SlotBits * Level)) & (NumSlots - 1));
+	Entry.Slot = Slot;
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = SlotHeads[Slot];
+	if (Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = EntryIndex;
+	}
+	SlotHeads[Slot] = EntryIndex;
+}
+
+void UChaosCooldownSubsystem::UnlinkEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.Prev != INDEX_NONE)
+	{
+		Entries[Entry.Prev].Next = Entry.Next;
+	}
+	else if (Entry.Slot != INDEX_NONE)
+	{
+		SlotHeads[Entry.Slot] = Entry.Next;
+	}
+
+	if (Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = Entry.Prev;
+	}
+
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+	Entry.Slot = INDEX_NONE;
+}
+
+void UChaosCooldownSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	UnlinkEntry(EntryIndex);
+	ActiveCooldowns.Remove(Entries[EntryIndex].Key);
+	Entries[EntryIndex].OnExpired.Unbind();
+	FreeEntries.Add(EntryIndex);
+}
+
+void UChaosCooldownSubsystem::MoveSlotToPending(int32 Slot)
+{
+	check(SlotHeads[PendingSlot] == INDEX_NONE);
+
+	SlotHeads[PendingSlot] = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	for (int32 EntryIndex = SlotHeads[PendingSlot]; EntryIndex != INDEX_NONE; EntryIndex = Entries[EntryIndex].Next)
+	{
+		Entries[EntryIndex].Slot = PendingSlot;
+	}
+}
+
+void UChaosCooldownSubsystem::AdvanceTick()
+{
+	const int64 Tick = NextTick;
+
+	// Whenever a finer level wraps around, the next slot of the coarser level comes within its range and is spread
+	// over the finer slots. Coarser levels go first so their entries can continue all the way down in the same tick.
+	for (int32 Level = NumLevels - 1; Level > 0; --Level)
+	{
+		if ((Tick & ((int64(1) << (SlotBits * Level)) - 1)) != 0)
+		{
+			continue;
+		}
+
+		MoveSlotToPending(Level * NumSlots + static_cast<int32>((Tick >> (SlotBits * Level)) & (NumSlots - 1)));
+		while (SlotHeads[PendingSlot] != INDEX_NONE)
+		{
+			const int32 EntryIndex = SlotHeads[PendingSlot];
+			UnlinkEntry(EntryIndex);
+			LinkEntry(EntryIndex);
+		}
+	}
+
+	// Cooldowns started from the callbacks below must not land in the slot being expired.
+	NextTick = Tick + 1;
+
+	MoveSlotToPending(static_cast<int32>(Tick & (NumSlots - 1)));
+	while (SlotHeads[PendingSlot] != INDEX_NONE)
+	{
+		const int32 EntryIndex = SlotHeads[PendingSlot];
+		UnlinkEntry(EntryIndex);
+
+		// Cooldowns longer than the wheel were placed at its far end and still have a lap to go.
+		if (Entries[EntryIndex].ExpireTick > Tick)
+		{
+			LinkEntry(EntryIndex);
+			continue;
+		}
+
+		// The callback may start or cancel cooldowns, so it runs only after the entry is fully removed.
+		FSimpleDelegate OnExpired = MoveTemp(Entries[EntryIndex].OnExpired);
+		RemoveEntry(EntryIndex);
+		OnExpired.ExecuteIfBound();
+	}
+}
+
+int64 UChaosCooldownSubsystem::TimeToTick(double Time) const
+{
+	return FMath::CeilToInt64(Time / TickResolution);
+}
@@ -4,6 +4,8 @@
 #include "EnhancedInputSubsystems.h"
 #include "Engine/LocalPlayer.h"
 #include "InputMappingContext.h"
+#include "UI/ChaosHealthBarSubsystem.h"
+#include "UI/ChaosHealthBarWidget.h"
 
 void AChaosPlayerController::SetupInputComponent()
 {
@@ -18,3 +20,17 @@ void AChaosPlayerController::SetupInputComponent()
 		}
 	}
 }
+
+void AChaosPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Enemy health bars are drawn into the local player's viewport from a fixed pool of widgets.
+	if (IsLocalController() && HealthBarWidgetClass)
+	{
+		if (UChaosHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UChaosHealthBarSubsystem>())
+		{
+			HealthBars->SetupHealthBars(this, HealthBarWidgetClass, MaxHealthBars, HealthBarMaxDistance, HealthBarWorldOffset);
+		}
+	}
+}
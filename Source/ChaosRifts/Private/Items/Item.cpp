@@ -17,6 +17,8 @@ void AItem::BeginPlay()
 {
 	Super::BeginPlay();
 
+	RebuildIgnoreFilters();
+
 	// Go through all CapsuleComponents already added in the editor and bind the overlap events.
 	// This is useful if the capsules are created directly in a Blueprint child of AItem.
 	TArray<UCapsuleComponent*> AllCapsules;
@@ -27,42 +29,65 @@ void AItem::BeginPlay()
 	}
 }
 
-void AItem::AddHitCapsule(UCapsuleComponent* CapsuleToAdd)
+void AItem::RebuildIgnoreFilters()
 {
-	if (CapsuleToAdd && !HitCapsules.Contains(CapsuleToAdd))
+	IgnoredActorSet.Reset();
+	for (AActor* IgnoredActor : IgnoredActors)
 	{
-		HitCapsules.Add(CapsuleToAdd);
-		
-		// Bind the overlap events for this specific capsule
-		CapsuleToAdd->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnHitCapsuleBeginOverlap);
-		CapsuleToAdd->OnComponentEndOverlap.AddDynamic(this, &AItem::OnHitCapsuleEndOverlap);
+		if (IgnoredActor)
+		{
+			IgnoredActorSet.Add(IgnoredActor);
+		}
 	}
 }
 
-void AItem::OnHitCapsuleBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AItem::SetIgnoredActors(const TArray<AActor*>& NewIgnoredActors)
+{
+	IgnoredActors.Reset();
+	IgnoredActors.Append(NewIgnoredActors);
+	RebuildIgnoreFilters();
+}
+
+bool AItem::IsIgnoredActor(const AActor* OtherActor) const
 {
-	// --- New Collision Ignore Logic ---
 	// Ignore the item itself.
 	if (OtherActor == this)
 	{
-		return;
+		return true;
 	}
 	// Ignore the owner if the flag is set.
 	if (bIgnoreOwner && OtherActor == GetOwner())
 	{
-		return;
+		return true;
 	}
 	// Ignore any actor instance present in the IgnoredActors array.
-	if (IgnoredActors.Contains(OtherActor))
+	return IgnoredActorSet.Contains(OtherActor);
+}
+
+void AItem::AddHitCapsule(UCapsuleComponent* CapsuleToAdd)
+{
+	if (CapsuleToAdd && !HitCapsules.Contains(CapsuleToAdd))
+	{
+		HitCapsules.Add(CapsuleToAdd);
+		
+		// Bind the overlap events for this specific capsule
+		CapsuleToAdd->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnHitCapsuleBeginOverlap);
+		CapsuleToAdd->OnComponentEndOverlap.AddDynamic(this, &AItem::OnHitCapsuleEndOverlap);
+	}
+}
+
+void AItem::OnHitCapsuleBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!OtherActor || IsIgnoredActor(OtherActor))
 	{
 		return;
 	}
-	// --- End New Logic ---
 
-	// Add the actor to the list if it's not already in it
-	if (!OverlappingActors.Contains(OtherActor))
+	// Only the first capsule an actor enters adds it to the list and sends an event.
+	FItemOverlapEntry& Entry = OverlapEntries.FindOrAdd(OtherActor);
+	if (++Entry.RefCount == 1)
 	{
-		OverlappingActors.Add(OtherActor);
+		Entry.ArrayIndex = OverlappingActors.Add(OtherActor);
 		// Send an event that a new actor is overlapping
 		OnItemOverlap.Broadcast(OtherActor, true);
 	}
@@ -70,16 +95,25 @@ void AItem::OnHitCapsuleBeginOverlap(UPrimitiveComponent* OverlappedComponent, A
 
 void AItem::OnHitCapsuleEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-    // Ignore the owner of the item (e.g., the character holding it) and the item itself.
-	if ((bIgnoreOwner && OtherActor == GetOwner()) || OtherActor == this)
+	// Actors that were ignored on begin overlap (including the owner and the item itself) were never counted.
+	FItemOverlapEntry* Entry = OverlapEntries.Find(OtherActor);
+	if (!Entry || --Entry->RefCount > 0)
 	{
 		return;
 	}
 
-	// Remove the actor from the list
-	if (OverlappingActors.Remove(OtherActor) > 0)
+	// The actor left its last capsule: swap-remove it from the list and patch the index of the moved actor.
+	const int32 RemovedIndex = Entry->ArrayIndex;
+	OverlapEntries.Remove(OtherActor);
+	OverlappingActors.RemoveAtSwap(RemovedIndex, 1, EAllowShrinking::No);
+	if (OverlappingActors.IsValidIndex(RemovedIndex))
 	{
-		// Send an event that the actor is no longer overlapping
-		OnItemOverlap.Broadcast(OtherActor, false);
+		if (FItemOverlapEntry* MovedEntry = OverlapEntries.Find(OverlappingActors[RemovedIndex].Get()))
+		{
+			MovedEntry->ArrayIndex = RemovedIndex;
+		}
 	}
+
+	// Send an event that the actor is no longer overlapping
+	OnItemOverlap.Broadcast(OtherActor, false);
 }
@@ -0,0 +1,274 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Items/Weapons/ChaosMusket.h"
+#include "Algo/Count.h"
+#include "Components/StaticMeshComponent.h"
+#include "Combat/ChaosDamageSubsystem.h"
+#include "Core/ChaosCombatTrace.h"
+#include "GameFramework/Controller.h"
+
+namespace ChaosMusketBallistics
+{
+	// The pellets of a shot are generated in groups of this many, one per vector lane.
+	static constexpr int32 LaneCount = 4;
+
+	// Turning every pellet of the pattern by this angle spreads them evenly over the cone (a sunflower pattern).
+	static constexpr float GoldenAngle = 2.39996323f;
+
+	/** The inputs for generating the pellet paths of a shot. */
+	struct FShotParams
+	{
+		FVector Muzzle;
+		FVector Forward;
+		FVector Right;
+		FVector Up;
+		int32 NumPellets = 0;
+		int32 NumSegments = 1;
+		float SpreadRadians = 0.f;
+		float PatternRoll = 0.f;
+		float Speed = 0.f;
+		float GravityZ = 0.f;
+		float FlightTime = 0.f;
+	};
+
+	/**
+	 * Generates the spread pattern of a shot and the ballistic arc of every pellet, four pellets per vector operation.
+	 * Pellet I sits at angle SpreadRadians * sqrt((I + 0.5) / NumPellets) from the aim direction (scaled by its
+	 * jitter), turned by I golden angles around it. Its arc is sampled at NumSegments + 1 evenly spaced times.
+	 * The arcs are computed as float offsets from the muzzle, so they stay precise far away from the world origin.
+	 * @param Jitters One scale per pellet, padded to a multiple of LaneCount.
+	 * @param OutPoints Receives NumSegments + 1 points per pellet, pellet-major.
+	 */
+	static void BuildPelletPaths(const FShotParams& Shot, TConstArrayView<float> Jitters, TArray<FVector>& OutPoints)
+	{
+		check(Jitters.Num() >= Align(Shot.NumPellets, LaneCount));
+
+		const int32 NumPoints = Shot.NumSegments + 1;
+		OutPoints.SetNumUninitialized(Shot.NumPellets * NumPoints, EAllowShrinking::No);
+
+		const VectorRegister4Float ForwardX = VectorSetFloat1(static_cast<float>(Shot.Forward.X));
+		const VectorRegister4Float ForwardY = VectorSetFloat1(static_cast<float>(Shot.Forward.Y));
+		const VectorRegister4Float ForwardZ = VectorSetFloat1(static_cast<float>(Shot.Forward.Z));
+		const VectorRegister4Float RightX = VectorSetFloat1(static_cast<float>(Shot.Right.X));
+		const VectorRegister4Float RightY = VectorSetFloat1(static_cast<float>(Shot.Right.Y));
+		const VectorRegister4Float RightZ = VectorSetFloat1(static_cast<float>(Shot.Right.Z));
+		const VectorRegister4Float UpX = VectorSetFloat1(static_cast<float>(Shot.Up.X));
+		const VectorRegister4Float UpY = VectorSetFloat1(static_cast<float>(Shot.Up.Y));
+		const VectorRegister4Float UpZ = VectorSetFloat1(static_cast<float>(Shot.Up.Z));
+
+		const VectorRegister4Float LaneOffsets = MakeVectorRegisterFloat(0.5f, 1.5f, 2.5f, 3.5f);
+		const VectorRegister4Float InvNumPellets = VectorSetFloat1(1.f / Shot.NumPellets);
+		const VectorRegister4Float Spread = VectorSetFloat1(Shot.SpreadRadians);
+		const VectorRegister4Float GoldenAngleV = VectorSetFloat1(GoldenAngle);
+		const VectorRegister4Float PatternRoll = VectorSetFloat1(Shot.PatternRoll);
+		const VectorRegister4Float Speed = VectorSetFloat1(Shot.Speed);
+		const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+
+		alignas(16) float OffsetsX[LaneCount];
+		alignas(16) float OffsetsY[LaneCount];
+		alignas(16) float OffsetsZ[LaneCount];
+
+		for (int32 FirstPellet = 0; FirstPellet < Shot.NumPellets; FirstPellet += LaneCount)
+		{
+			// Pattern: the indices of the four pellets, centered in their slots (I + 0.5).
+			const VectorRegister4Float Slots = VectorAdd(VectorSetFloat1(static_cast<float>(FirstPellet)), LaneOffsets);
+			const VectorRegister4Float Theta = VectorMultiply(VectorMultiply(Spread, VectorSqrt(VectorMultiply(Slots, InvNumPellets))), VectorLoad(Jitters.GetData() + FirstPellet));
+			const VectorRegister4Float Phi = VectorMultiplyAdd(VectorSubtract(Slots, Half), GoldenAngleV, PatternRoll);
+
+			VectorRegister4Float SinTheta, CosTheta, SinPhi, CosPhi;
+			VectorSinCos(&SinTheta, &CosTheta, &Theta);
+			VectorSinCos(&SinPhi, &CosPhi, &Phi);
+
+			// Velocity = (Forward * cos(Theta) + (Right * cos(Phi) + Up * sin(Phi)) * sin(Theta)) * Speed
+			const VectorRegister4Float VelocityX = VectorMultiply(VectorMultiplyAdd(VectorMultiplyAdd(RightX, CosPhi, VectorMultiply(UpX, SinPhi)), SinTheta, VectorMultiply(ForwardX, CosTheta)), Speed);
+			const VectorRegister4Float VelocityY = VectorMultiply(VectorMultiplyAdd(VectorMultiplyAdd(RightY, CosPhi, VectorMultiply(UpY, SinPhi)), SinTheta, VectorMultiply(ForwardY, CosTheta)), Speed);
+			const VectorRegister4Float VelocityZ = VectorMultiply(VectorMultiplyAdd(VectorMultiplyAdd(RightZ, CosPhi, VectorMultiply(UpZ, SinPhi)), SinTheta, VectorMultiply(ForwardZ, CosTheta)), Speed);
+
+			const int32 NumLanes = FMath::Min(LaneCount, Shot.NumPellets - FirstPellet);
+			for (int32 Point = 0; Point < NumPoints; ++Point)
+			{
+				// Offset = Velocity * t + (0, 0, Gravity * t^2 / 2)
+				const float Time = Shot.FlightTime * Point / Shot.NumSegments;
+				const VectorRegister4Float TimeV = VectorSetFloat1(Time);
+				VectorStoreAligned(VectorMultiply(VelocityX, TimeV), OffsetsX);
+				VectorStoreAligned(VectorMultiply(VelocityY, TimeV), OffsetsY);
+				VectorStoreAligned(VectorMultiplyAdd(VelocityZ, TimeV, VectorSetFloat1(0.5f * Shot.GravityZ * Time * Time)), OffsetsZ);
+
+				for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+				{
+					OutPoints[(FirstPellet + Lane) * NumPoints + Point] = Shot.Muzzle + FVector(OffsetsX[Lane], OffsetsY[Lane], OffsetsZ[Lane]);
+				}
+			}
+		}
+	}
+
+	/** The object types pellets collide with: the world stops them, the target type is damaged. */
+	static FCollisionObjectQueryParams MakeObjectQueryParams(ECollisionChannel TargetObjectType)
+	{
+		FCollisionObjectQueryParams ObjectParams;
+		ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+		ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+		ObjectParams.AddObjectTypesToQuery(TargetObjectType);
+		return ObjectParams;
+	}
+}
+
+AChaosMusket::AChaosMusket()
+{
+	// Shots are fired with Damage per pellet.
+	Damage = 12.f;
+
+	// Ticking is also used to collect the trace results of shots and is enabled while they are in flight.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void AChaosMusket::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SpreadStream.GenerateNewSeed();
+}
+
+void AChaosMusket::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ResolvePendingShots();
+	UpdateTickEnabled();
+}
+
+bool AChaosMusket::WantsTick() const
+{
+	// Shots in flight have to be collected on the next frame, whatever state the weapon is in by then.
+	return Super::WantsTick() || !PendingShots.IsEmpty();
+}
+
+bool AChaosMusket::IsReadyToFire() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->GetTimeSeconds() - LastFireTime >= ReloadTime;
+}
+
+bool AChaosMusket::Fire(const FVector& AimDirection)
+{
+	UWorld* World = GetWorld();
+	AActor* MyOwner = GetOwner();
+	if (!World || !MyOwner || !IsReadyToFire())
+	{
+		return false;
+	}
+	LastFireTime = World->GetTimeSeconds();
+
+	ChaosMusketBallistics::FShotParams Shot;
+	Shot.Muzzle = ItemMesh && ItemMesh->DoesSocketExist(MuzzleSocketName) ? ItemMesh->GetSocketLocation(MuzzleSocketName) : GetActorLocation();
+	Shot.Forward = AimDirection.GetSafeNormal(UE_SMALL_NUMBER, GetActorForwardVector());
+	Shot.Forward.FindBestAxisVectors(Shot.Right, Shot.Up);
+	Shot.NumPellets = PelletCount;
+	Shot.NumSegments = PelletGravityScale > 0.f ? BallisticSegments : 1;
+	Shot.SpreadRadians = FMath::DegreesToRadians(SpreadAngle);
+	Shot.PatternRoll = SpreadStream.FRandRange(0.f, UE_TWO_PI);
+	Shot.Speed = MuzzleVelocity;
+	Shot.GravityZ = World->GetGravityZ() * PelletGravityScale;
+	Shot.FlightTime = MaxRange / MuzzleVelocity;
+
+	// Random numbers are drawn one by one; everything derived from them is computed in vector lanes.
+	PelletJitters.SetNumUninitialized(Align(PelletCount, ChaosMusketBallistics::LaneCount), EAllowShrinking::No);
+	for (float& Jitter : PelletJitters)
+	{
+		Jitter = 1.f + SpreadStream.FRandRange(-SpreadJitter, SpreadJitter);
+	}
+	ChaosMusketBallistics::BuildPelletPaths(Shot, PelletJitters, PelletPathPoints);
+
+	// Hand every segment of the blast to the physics scene at once; they are traced in parallel with the rest of the
+	// frame and collected on the next one.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosMusketPellet), false, this);
+	if (bIgnoreOwner)
+	{
+		QueryParams.AddIgnoredActor(MyOwner);
+	}
+	const FCollisionObjectQueryParams ObjectParams = ChaosMusketBallistics::MakeObjectQueryParams(TraceObjectType.GetValue());
+
+	FPendingShot& PendingShot = PendingShots.AddDefaulted_GetRef();
+	PendingShot.FrameNumber = GFrameCounter;
+	PendingShot.NumSegments = Shot.NumSegments;
+	PendingShot.Instigator = MyOwner->GetInstigatorController();
+	PendingShot.Handles.Reserve(Shot.NumPellets * Shot.NumSegments);
+
+	const int32 NumPoints = Shot.NumSegments + 1;
+	for (int32 Pellet = 0; Pellet < Shot.NumPellets; ++Pellet)
+	{
+		const FVector* PathPoints = &PelletPathPoints[Pellet * NumPoints];
+		for (int32 Segment = 0; Segment < Shot.NumSegments; ++Segment)
+		{
+			PendingShot.Handles.Add(World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, PathPoints[Segment], PathPoints[Segment + 1], ObjectParams, QueryParams));
+		}
+	}
+
+	UpdateTickEnabled();
+	return true;
+}
+
+void AChaosMusket::ResolvePendingShots()
+{
+	UWorld* World = GetWorld();
+
+	// Shots of this frame are still being traced.
+	const int32 NumCompletedShots = Algo::CountIf(PendingShots, [](const FPendingShot& Shot) { return Shot.FrameNumber < GFrameCounter; });
+	if (NumCompletedShots == 0)
+	{
+		return;
+	}
+
+	// The pellets of a shot that hit the same target are dealt as one hit, since the damage subsystem counts
+	// several hits of the same causer on a target in one frame only once.
+	TArray<TPair<AActor*, int32>, TInlineAllocator<16>> TargetPellets;
+
+	for (int32 ShotIndex = 0; ShotIndex < NumCompletedShots; ++ShotIndex)
+	{
+		const FPendingShot& Shot = PendingShots[ShotIndex];
+		TargetPellets.Reset();
+
+		const int32 NumPellets = Shot.Handles.Num() / Shot.NumSegments;
+		for (int32 Pellet = 0; Pellet < NumPellets; ++Pellet)
+		{
+			// The pellet stops at the first segment that hits something. A segment without results ends the pellet too,
+			// so it can never pass through a wall.
+			for (int32 Segment = 0; Segment < Shot.NumSegments; ++Segment)
+			{
+				FTraceDatum TraceData;
+				if (!World->QueryTraceData(Shot.Handles[Pellet * Shot.NumSegments + Segment], TraceData))
+				{
+					break;
+				}
+				if (TraceData.OutHits.IsEmpty())
+				{
+					continue;
+				}
+
+				AActor* HitActor = TraceData.OutHits[0].GetActor();
+				if (HitActor && HitActor->CanBeDamaged() && !IsIgnoredTarget(HitActor))
+				{
+					if (TPair<AActor*, int32>* Existing = TargetPellets.FindByPredicate([HitActor](const TPair<AActor*, int32>& Entry) { return Entry.Key == HitActor; }))
+					{
+						++Existing->Value;
+					}
+					else
+					{
+						TargetPellets.Emplace(HitActor, 1);
+					}
+				}
+				break;
+			}
+		}
+
+		for (const TPair<AActor*, int32>& Target : TargetPellets)
+		{
+			const float TotalDamage = Damage * Target.Value;
+			UChaosDamageSubsystem::QueueDamage(Target.Key, TotalDamage, Shot.Instigator.Get(), this, nullptr);
+			FChaosCombatTrace::Record(EChaosCombatEvent::PelletHit, this, Target.Key, TotalDamage, static_cast<float>(Target.Value));
+		}
+	}
+
+	PendingShots.RemoveAt(0, NumCompletedShots, EAllowShrinking::No);
+}
@@ -0,0 +1,174 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Items/Weapons/ChaosWeaponComponent.h"
+#include "Combat/ChaosDamageSubsystem.h"
+#include "GameFramework/Actor.h"
+
+UChaosWeaponComponent::UChaosWeaponComponent()
+{
+	// Ticking is only used for sweep hit detection and is enabled while the weapon is Aggressive.
+	// Ticking after physics ensures the owner's animation has already moved the weapon this frame.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UChaosWeaponComponent::InitializeFromWeaponClass(TSubclassOf<AWeapon> InWeaponClass)
+{
+	WeaponClass = InWeaponClass;
+	const AWeapon* WeaponDefaults = WeaponClass ? WeaponClass->GetDefaultObject<AWeapon>() : nullptr;
+	if (!WeaponDefaults)
+	{
+		return;
+	}
+
+	if (const UStaticMeshComponent* DefaultMesh = WeaponDefaults->ItemMesh)
+	{
+		SetStaticMesh(DefaultMesh->GetStaticMesh());
+		for (int32 MaterialIndex = 0; MaterialIndex < DefaultMesh->OverrideMaterials.Num(); ++MaterialIndex)
+		{
+			SetMaterial(MaterialIndex, DefaultMesh->OverrideMaterials[MaterialIndex]);
+		}
+		SetRelativeScale3D(DefaultMesh->GetRelativeScale3D());
+
+		SetCollisionEnabled(DefaultMesh->GetCollisionEnabled());
+		SetCollisionObjectType(DefaultMesh->GetCollisionObjectType());
+		SetCollisionResponseToChannels(DefaultMesh->GetCollisionResponseToChannels());
+		SetGenerateOverlapEvents(DefaultMesh->GetGenerateOverlapEvents());
+	}
+
+	Damage = WeaponDefaults->Damage;
+	IgnoredActorClasses = WeaponDefaults->IgnoredActorClasses;
+	IgnoredActors = WeaponDefaults->IgnoredActors;
+	HitDetectionMode = WeaponDefaults->HitDetectionMode;
+	TraceSocketNames = WeaponDefaults->TraceSocketNames;
+	TraceRadius = WeaponDefaults->TraceRadius;
+	SweepSubsteps = WeaponDefaults->SweepSubsteps;
+	TraceObjectType = WeaponDefaults->TraceObjectType;
+}
+
+void UChaosWeaponComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RebuildIgnoreFilters();
+
+	if (HitDetectionMode == EWeaponHitDetectionMode::Sweep)
+	{
+		// Sweeps replace the overlap events, so physics does not need to keep overlap pairs for this mesh.
+		SetGenerateOverlapEvents(false);
+		WeaponSweep.ResolveTracePoints(this, TraceSocketNames);
+	}
+	else
+	{
+		OnComponentBeginOverlap.AddDynamic(this, &UChaosWeaponComponent::OnWeaponBeginOverlap);
+	}
+}
+
+void UChaosWeaponComponent::SetIgnoredActorClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredActorClasses)
+{
+	IgnoredActorClasses = NewIgnoredActorClasses;
+	RebuildIgnoreFilters();
+}
+
+void UChaosWeaponComponent::SetIgnoredActors(const TArray<AActor*>& NewIgnoredActors)
+{
+	IgnoredActors.Reset();
+	IgnoredActors.Append(NewIgnoredActors);
+	RebuildIgnoreFilters();
+}
+
+void UChaosWeaponComponent::RebuildIgnoreFilters()
+{
+	IgnoredClassFilter.Compile(IgnoredActorClasses);
+
+	IgnoredActorSet.Reset();
+	for (AActor* IgnoredActor : IgnoredActors)
+	{
+		if (IgnoredActor)
+		{
+			IgnoredActorSet.Add(IgnoredActor);
+		}
+	}
+}
+
+void UChaosWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (CurrentWeaponState != EWeaponState::Aggressive || HitDetectionMode != EWeaponHitDetectionMode::Sweep)
+	{
+		return;
+	}
+
+	// The wielder is never a target of its own weapon.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(WeaponSweep), false, GetOwner());
+	WeaponSweep.Sweep(this, TraceRadius, SweepSubsteps, TraceObjectType.GetValue(), QueryParams, [this](AActor* HitActor)
+	{
+		TryDamageActor(HitActor);
+	});
+}
+
+void UChaosWeaponComponent::SetWeaponState(EWeaponState NewState)
+{
+	const bool bBecameAggressive = CurrentWeaponState != EWeaponState::Aggressive && NewState == EWeaponState::Aggressive;
+	CurrentWeaponState = NewState;
+
+	// Every aggressive window is a new swing, so actors hit in earlier swings can be hit again.
+	if (bBecameAggressive)
+	{
+		SwingTracker.BeginSwing();
+	}
+
+	if (HitDetectionMode == EWeaponHitDetectionMode::Sweep)
+	{
+		// The first sweep of a swing starts at the pose the weapon had when it became aggressive.
+		if (bBecameAggressive)
+		{
+			WeaponSweep.BeginSweeping(this);
+		}
+		SetComponentTickEnabled(NewState == EWeaponState::Aggressive);
+	}
+}
+
+void UChaosWeaponComponent::OnWeaponBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// We are only interested in overlaps while the weapon is aggressive.
+	if (CurrentWeaponState != EWeaponState::Aggressive)
+	{
+		return;
+	}
+
+	TryDamageActor(OtherActor);
+}
+
+void UChaosWeaponComponent::TryDamageActor(AActor* OtherActor)
+{
+	AActor* MyOwner = GetOwner();
+	if (!OtherActor || !MyOwner || OtherActor == MyOwner)
+	{
+		return;
+	}
+
+	if (IgnoredActorSet.Contains(OtherActor) || IgnoredClassFilter.IsIgnored(OtherActor))
+	{
+		return;
+	}
+
+	// Prevent hitting the same actor multiple times in the same swing.
+	if (!SwingTracker.TryMarkHit(OtherActor))
+	{
+		return;
+	}
+
+	// Queue the damage; it is resolved together with all other hits at the end of the frame.
+	// Without a weapon actor, the wielder is the damage causer. The damage subsystem sums every queued hit, so this
+	// hit adds up with the wielder's other hits on the same target instead of being merged into them.
+	UChaosDamageSubsystem::QueueDamage(
+		OtherActor,
+		Damage,
+		MyOwner->GetInstigatorController(),
+		MyOwner,
+		nullptr
+	);
+}
@@ -2,8 +2,9 @@
 
 #include "Items/Weapons/Weapon.h"
 #include "Components/StaticMeshComponent.h"
-#include "Kismet/GameplayStatics.h"
 #include "GameFramework/Character.h"
+#include "Combat/ChaosDamageSubsystem.h"
+#include "Engine/World.h"
 
 AWeapon::AWeapon()
 {
@@ -11,30 +12,94 @@ AWeapon::AWeapon()
 	CurrentWeaponState = EWeaponState::Passive;
 	Damage = 25.f;
 	// bIgnoreOwner is now set in the base AItem class, so no need to set it here.
+
+	// Ticking is only used for sweep hit detection and is enabled while the weapon is Aggressive.
+	// Ticking after physics ensures the owner's animation has already moved the weapon this frame.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
 }
 
 void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Bind our handle function to the mesh's overlap delegate.
 	// ItemMesh is now guaranteed to exist from the AItem base class.
-	if (ItemMesh)
+	if (!ItemMesh)
 	{
+		return;
+	}
+
+	if (HitDetectionMode == EWeaponHitDetectionMode::Sweep)
+	{
+		// Sweeps replace the overlap events, so physics does not need to keep overlap pairs for this mesh.
+		ItemMesh->SetGenerateOverlapEvents(false);
+
+		// Resolve the socket locations once; they are constant relative to the mesh.
+		WeaponSweep.ResolveTracePoints(ItemMesh, TraceSocketNames);
+	}
+	else
+	{
+		// Bind our handle function to the mesh's overlap delegate.
 		ItemMesh->OnComponentBeginOverlap.AddDynamic(this, &AWeapon::OnMeshBeginOverlap);
 	}
 }
 
+void AWeapon::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (CurrentWeaponState == EWeaponState::Aggressive && HitDetectionMode == EWeaponHitDetectionMode::Sweep)
+	{
+		SweepTraceSockets();
+	}
+}
+
+void AWeapon::RebuildIgnoreFilters()
+{
+	Super::RebuildIgnoreFilters();
+	IgnoredClassFilter.Compile(IgnoredActorClasses);
+}
+
+void AWeapon::SetIgnoredActorClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredActorClasses)
+{
+	IgnoredActorClasses = NewIgnoredActorClasses;
+	RebuildIgnoreFilters();
+}
+
+bool AWeapon::IsIgnoredTarget(const AActor* OtherActor) const
+{
+	return IsIgnoredActor(OtherActor) || IgnoredClassFilter.IsIgnored(OtherActor);
+}
+
 void AWeapon::SetWeaponState(EWeaponState NewState)
 {
+	const bool bBecameAggressive = CurrentWeaponState != EWeaponState::Aggressive && NewState == EWeaponState::Aggressive;
 	CurrentWeaponState = NewState;
 
-	// When the weapon returns to the passive state, we clear the list of
-	// hit actors so that the next attack is fresh.
-	if (NewState == EWeaponState::Passive)
+	// Every aggressive window is a new swing, so actors hit in earlier swings can be hit again.
+	if (bBecameAggressive)
+	{
+		SwingTracker.BeginSwing();
+	}
+
+	// The first sweep of a swing starts at the pose the weapon had when it became aggressive.
+	if (bBecameAggressive && HitDetectionMode == EWeaponHitDetectionMode::Sweep && ItemMesh)
 	{
-		DamagedActorsInSwing.Empty();
+		WeaponSweep.BeginSweeping(ItemMesh);
 	}
+
+	UpdateTickEnabled();
+}
+
+bool AWeapon::WantsTick() const
+{
+	return CurrentWeaponState == EWeaponState::Aggressive && HitDetectionMode == EWeaponHitDetectionMode::Sweep && ItemMesh != nullptr;
+}
+
+void AWeapon::UpdateTickEnabled()
+{
+	SetActorTickEnabled(WantsTick());
 }
 
 void AWeapon::OnMeshBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -45,49 +110,59 @@ void AWeapon::OnMeshBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActo
 		return;
 	}
 
-	AActor* MyOwner = GetOwner();
+	TryDamageActor(OtherActor);
+}
 
-	// --- Enhanced Collision Ignore Logic ---
-	// Check if we should ignore the owner (uses bIgnoreOwner from AItem).
-	if (bIgnoreOwner && OtherActor == MyOwner)
+void AWeapon::SweepTraceSockets()
+{
+	if (!ItemMesh)
 	{
 		return;
 	}
-	
-	// Check if the actor instance is in the inherited ignored list.
-	if (IgnoredActors.Contains(OtherActor))
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(WeaponSweep), false, this);
+	if (bIgnoreOwner)
 	{
-		return;
+		QueryParams.AddIgnoredActor(GetOwner());
 	}
 
-	// Check if the overlapped actor's class is in the weapon's specific ignored list.
-    for (TSubclassOf<AActor> ClassToIgnore : IgnoredActorClasses)
-    {
-        if (OtherActor != nullptr && OtherActor->IsA(ClassToIgnore))
-        {
-            return;
-        }
-    }
-	// --- End Enhanced Logic ---
+	WeaponSweep.Sweep(ItemMesh, TraceRadius, SweepSubsteps, TraceObjectType.GetValue(), QueryParams, [this](AActor* HitActor)
+	{
+		TryDamageActor(HitActor);
+	});
+}
 
-	// Prevent hitting the same actor multiple times in the same swing.
-	if (DamagedActorsInSwing.Contains(OtherActor))
+void AWeapon::TryDamageActor(AActor* OtherActor)
+{
+	if (!OtherActor)
 	{
 		return;
 	}
 
+	AActor* MyOwner = GetOwner();
+
 	// Ensure the owner of the weapon is valid before dealing damage.
 	if (!MyOwner)
 	{
 		return;
 	}
 
-	// Add the hit actor to the list.
-	DamagedActorsInSwing.Add(OtherActor);
+	// Check the owner and the ignored actor instances (inherited from AItem),
+	// then the weapon's compiled list of ignored classes.
+	if (IsIgnoredTarget(OtherActor))
+	{
+		return;
+	}
+
+	// Prevent hitting the same actor multiple times in the same swing.
+	if (!SwingTracker.TryMarkHit(OtherActor))
+	{
+		return;
+	}
 
-	// Apply damage.
+	// Queue the damage; it is resolved together with all other hits at the end of the frame.
 	AController* InstigatorController = MyOwner->GetInstigatorController();
-	UGameplayStatics::ApplyDamage(
+	UChaosDamageSubsystem::QueueDamage(
 		OtherActor,
 		Damage,
 		InstigatorController,
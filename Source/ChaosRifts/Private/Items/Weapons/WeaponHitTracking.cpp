@@ -0,0 +1,307 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Items/Weapons/WeaponHitTracking.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace ChaosWeaponHitTracking
+{
+	// Once a weapon has stamped this many targets, stale stamps are dropped at the start of the next swing.
+	static constexpr int32 MaxTrackedTargets = 256;
+}
+
+void FChaosSwingTracker::BeginSwing()
+{
+	++CurrentSwingId;
+
+	// All stamps are stale at this point. Only drop them when the map has grown large (or the ID wrapped),
+	// so regular swings do not pay for clearing it.
+	if (CurrentSwingId == 0 || LastHitSwing.Num() > ChaosWeaponHitTracking::MaxTrackedTargets)
+	{
+		LastHitSwing.Reset();
+		CurrentSwingId = FMath::Max(CurrentSwingId, 1u);
+	}
+}
+
+bool FChaosSwingTracker::TryMarkHit(const AActor* Target)
+{
+	if (!Target || CurrentSwingId == 0)
+	{
+		return false;
+	}
+
+	uint32& LastSwing = LastHitSwing.FindOrAdd(Target, 0);
+	if (LastSwing == CurrentSwingId)
+	{
+		return false;
+	}
+
+	LastSwing = CurrentSwingId;
+	return true;
+}
+
+void FChaosActorClassFilter::Compile(TConstArrayView<TSubclassOf<AActor>> InIgnoredClasses)
+{
+	IgnoredClasses.Reset();
+	ClassResults.Reset();
+
+	for (const TSubclassOf<AActor>& IgnoredClass : InIgnoredClasses)
+	{
+		if (UClass* Class = IgnoredClass.Get())
+		{
+			IgnoredClasses.AddUnique(Class);
+			ClassResults.Add(Class, true);
+		}
+	}
+}
+
+bool FChaosActorClassFilter::IsIgnored(const AActor* Actor) const
+{
+	if (!Actor || IgnoredClasses.Num() == 0)
+	{
+		return false;
+	}
+
+	const UClass* ActorClass = Actor->GetClass();
+	if (const bool* CachedResult = ClassResults.Find(ActorClass))
+	{
+		return *CachedResult;
+	}
+
+	// First time we meet this class: resolve it against the ignored classes and remember the result.
+	bool bIgnored = false;
+	for (const TObjectKey<UClass>& IgnoredClassKey : IgnoredClasses)
+	{
+		const UClass* IgnoredClass = IgnoredClassKey.ResolveObjectPtr();
+		if (IgnoredClass && ActorClass->IsChildOf(IgnoredClass))
+		{
+			bIgnored = true;
+			break;
+		}
+	}
+
+	ClassResults.Add(ActorClass, bIgnored);
+	return bIgnored;
+}
+
+void FChaosWeaponSweep::ResolveTracePoints(const USceneComponent* Mesh, TConstArrayView<FName> SocketNames)
+{
+	TracePointLocations.Reset();
+	for (const FName& SocketName : SocketNames)
+	{
+		if (Mesh->DoesSocketExist(SocketName))
+		{
+			TracePointLocations.Add(Mesh->GetSocketTransform(SocketName, RTS_Component).GetLocation());
+		}
+	}
+	if (TracePointLocations.Num() == 0)
+	{
+		TracePointLocations.Add(FVector::ZeroVector);
+	}
+}
+
+void FChaosWeaponSweep::BeginSweeping(const USceneComponent* Mesh)
+{
+	PreviousMeshTransform = Mesh->GetComponentTransform();
+}
+
+void FChaosWeaponSweep::Sweep(const USceneComponent* Mesh, float Radius, int32 Substeps, ECollisionChannel ObjectType, const FCollisionQueryParams& QueryParams, TFunctionRef<void(AActor*)> OnHitActor)
+{
+	UWorld* World = Mesh->GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const FTransform CurrentMeshTransform = Mesh->GetComponentTransform();
+	const FCollisionShape SweepShape = FCollisionShape::MakeSphere(Radius);
+	const FCollisionObjectQueryParams ObjectParams(ObjectType);
+
+	// Sweep every point through each interpolated pose between the last sweep and this one.
+	const int32 NumSteps = Substeps + 1;
+	FTransform StepStartTransform = PreviousMeshTransform;
+	for (int32 Step = 1; Step <= NumSteps; ++Step)
+	{
+		FTransform StepEndTransform;
+		StepEndTransform.Blend(PreviousMeshTransform, CurrentMeshTransform, static_cast<float>(Step) / NumSteps);
+
+		for (const FVector& TracePointLocation : TracePointLocations)
+		{
+			SweepHits.Reset();
+			World->SweepMultiByObjectType(
+				SweepHits,
+				StepStartTransform.TransformPosition(TracePointLocation),
+				StepEndTransform.TransformPosition(TracePointLocation),
+				FQuat::Identity,
+				ObjectParams,
+				SweepShape,
+				QueryParams
+			);
+
+			for (const FHitResult& Hit : SweepHits)
+			{
+				OnHitActor(Hit.GetActor());
+			}
+		}
+
+		StepStartTransform = StepEndTransform;
+	}
+
+	PreviousMeshTransform = CurrentMeshTransform;
+}
+
+#if !UE_BUILD_SHIPPING
+
+DEFINE_LOG_CATEGORY_STATIC(LogChaosWeapon, Log, All);
+
+namespace ChaosWeaponHitTracking
+{
+	/**
+	 * Compares the original AWeapon filter path (TArray::Contains and an IsA loop per overlap, emptying the
+	 * hit list every swing) against swing stamps and the compiled class filter.
+	 * Actor class default objects are used as stand-ins for targets of many different classes. The ignored classes
+	 * are picked so that no target derives from them; otherwise every target would be filtered out and the
+	 * benchmark would only measure the early-out.
+	 * Usage: Chaos.Weapon.BenchmarkHitFilter [NumTargets=64] [NumIgnoredClasses=4] [NumSwings=2000]
+	 */
+	static void RunHitFilterBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumTargets = Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 64;
+		const int32 NumIgnoredClasses = Args.IsValidIndex(1) ? FMath::Max(0, FCString::Atoi(*Args[1])) : 4;
+		const int32 NumSwings = Args.IsValidIndex(2) ? FMath::Max(1, FCString::Atoi(*Args[2])) : 2000;
+		constexpr int32 NumIgnoredInstances = 2;
+		constexpr int32 OverlapsPerTargetAndSwing = 3;
+
+		TArray<UClass*> ActorClasses;
+		for (TObjectIterator<UClass> It; It; ++It)
+		{
+			UClass* Class = *It;
+			if (Class->IsChildOf(AActor::StaticClass()) && !Class->HasAnyClassFlags(CLASS_NewerVersionExists))
+			{
+				ActorClasses.Add(Class);
+			}
+		}
+
+		TArray<AActor*> Targets;
+		for (UClass* Class : ActorClasses)
+		{
+			if (Targets.Num() == NumTargets)
+			{
+				break;
+			}
+			Targets.Add(Class->GetDefaultObject<AActor>());
+		}
+
+		TArray<TSubclassOf<AActor>> IgnoredClasses;
+		TArray<AActor*> IgnoredInstances;
+		for (UClass* Class : ActorClasses)
+		{
+			const bool bIsTargetClass = Targets.ContainsByPredicate([Class](const AActor* Target) { return Target->GetClass()->IsChildOf(Class); });
+			if (bIsTargetClass)
+			{
+				continue;
+			}
+
+			if (IgnoredClasses.Num() < NumIgnoredClasses)
+			{
+				IgnoredClasses.Add(Class);
+			}
+			else if (IgnoredInstances.Num() < NumIgnoredInstances)
+			{
+				IgnoredInstances.Add(Class->GetDefaultObject<AActor>());
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		// --- Old path ---
+		int32 OldHits = 0;
+		const uint64 OldStartCycles = FPlatformTime::Cycles64();
+		{
+			TArray<AActor*> DamagedActorsInSwing;
+			for (int32 Swing = 0; Swing < NumSwings; ++Swing)
+			{
+				for (int32 Pass = 0; Pass < OverlapsPerTargetAndSwing; ++Pass)
+				{
+					for (AActor* Target : Targets)
+					{
+						if (IgnoredInstances.Contains(Target))
+						{
+							continue;
+						}
+						bool bIgnoredClass = false;
+						for (const TSubclassOf<AActor>& ClassToIgnore : IgnoredClasses)
+						{
+							if (Target->IsA(ClassToIgnore))
+							{
+								bIgnoredClass = true;
+								break;
+							}
+						}
+						if (bIgnoredClass || DamagedActorsInSwing.Contains(Target))
+						{
+							continue;
+						}
+						DamagedActorsInSwing.Add(Target);
+						++OldHits;
+					}
+				}
+				DamagedActorsInSwing.Empty();
+			}
+		}
+		const double OldMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - OldStartCycles);
+
+		// --- New path ---
+		int32 NewHits = 0;
+		const uint64 NewStartCycles = FPlatformTime::Cycles64();
+		{
+			TSet<TObjectKey<AActor>> IgnoredInstanceSet;
+			for (AActor* IgnoredInstance : IgnoredInstances)
+			{
+				IgnoredInstanceSet.Add(IgnoredInstance);
+			}
+			FChaosActorClassFilter ClassFilter;
+			ClassFilter.Compile(IgnoredClasses);
+			FChaosSwingTracker SwingTracker;
+
+			for (int32 Swing = 0; Swing < NumSwings; ++Swing)
+			{
+				SwingTracker.BeginSwing();
+				for (int32 Pass = 0; Pass < OverlapsPerTargetAndSwing; ++Pass)
+				{
+					for (AActor* Target : Targets)
+					{
+						if (IgnoredInstanceSet.Contains(Target) || ClassFilter.IsIgnored(Target) || !SwingTracker.TryMarkHit(Target))
+						{
+							continue;
+						}
+						++NewHits;
+					}
+				}
+			}
+		}
+		const double NewMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - NewStartCycles);
+
+		UE_LOG(LogChaosWeapon, Display, TEXT("Weapon hit filter benchmark: %d targets, %d ignored classes, %d swings x %d overlaps."),
+			Targets.Num(), IgnoredClasses.Num(), NumSwings, OverlapsPerTargetAndSwing);
+		UE_LOG(LogChaosWeapon, Display, TEXT("  Old path: %.3f ms (%d hits)"), OldMs, OldHits);
+		UE_LOG(LogChaosWeapon, Display, TEXT("  New path: %.3f ms (%d hits), speedup %.2fx"), NewMs, NewHits, NewMs > 0.0 ? OldMs / NewMs : 0.0);
+		if (OldHits != NewHits)
+		{
+			UE_LOG(LogChaosWeapon, Error, TEXT("  Hit counts differ between the old and the new path!"));
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkHitFilterCommand(
+		TEXT("Chaos.Weapon.BenchmarkHitFilter"),
+		TEXT("Compares the old and new weapon hit filtering. Args: [NumTargets] [NumIgnoredClasses] [NumSwings]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunHitFilterBenchmark)
+	);
+}
+
+#endif // !UE_BUILD_SHIPPING
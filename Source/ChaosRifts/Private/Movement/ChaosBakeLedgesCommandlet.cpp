@@ -0,0 +1,355 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Movement/ChaosBakeLedgesCommandlet.h"
+#include "Movement/ChaosLedgeIndex.h"
+#include "Characters/Player/ChaosCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "StaticMeshResources.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogChaosLedgeBake, Log, All);
+
+#if WITH_EDITOR
+namespace ChaosLedgeBake
+{
+	// Slopes steeper than this count as walls, flatter ones as walkable tops.
+	static constexpr float MaxWallNormalZ = 0.3f;
+	static constexpr float MinTopNormalZ = 0.7f;
+
+	/** A candidate ledge edge in world space. */
+	struct FLedgeEdge
+	{
+		FVector Start;
+		FVector End;
+		FVector Normal;
+	};
+
+	/**
+	 * Finds the edges of a mesh where a walkable top meets a wall below it. Works on welded LOD0 positions, so
+	 * split vertices (UV seams, hard normals) do not hide shared edges. Independent of triangle winding.
+	 */
+	static void ExtractMeshLedges(const UStaticMesh* Mesh, const FTransform& Transform, TArray<FLedgeEdge>& OutEdges)
+	{
+		const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+		if (!RenderData || RenderData->LODResources.IsEmpty())
+		{
+			return;
+		}
+
+		const FStaticMeshLODResources& LOD = RenderData->LODResources[0];
+		const FPositionVertexBuffer& PositionBuffer = LOD.VertexBuffers.PositionVertexBuffer;
+		const FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+
+		TArray<FVector> Positions;
+		TArray<int32> Remap;
+		TMap<FIntVector, int32> Welded;
+		Remap.SetNumUninitialized(PositionBuffer.GetNumVertices());
+		for (uint32 VertexIndex = 0; VertexIndex < PositionBuffer.GetNumVertices(); ++VertexIndex)
+		{
+			const FVector Position = Transform.TransformPosition(FVector(PositionBuffer.VertexPosition(VertexIndex)));
+			const FIntVector Key(FMath::RoundToInt32(Position.X), FMath::RoundToInt32(Position.Y), FMath::RoundToInt32(Position.Z));
+			if (const int32* WeldedIndex = Welded.Find(Key))
+			{
+				Remap[VertexIndex] = *WeldedIndex;
+			}
+			else
+			{
+				Remap[VertexIndex] = Positions.Add(Position);
+				Welded.Add(Key, Remap[VertexIndex]);
+			}
+		}
+
+		// Collect the triangles on both sides of every edge.
+		TArray<FIntVector> Triangles;
+		TArray<float> NormalZ;
+		TMap<uint64, TArray<int32, TInlineAllocator<2>>> EdgeTriangles;
+		for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+		{
+			const FIntVector Triangle(Remap[Indices[Index]], Remap[Indices[Index + 1]], Remap[Indices[Index + 2]]);
+			if (Triangle.X == Triangle.Y || Triangle.Y == Triangle.Z || Triangle.Z == Triangle.X)
+			{
+				continue;
+			}
+
+			const FVector Normal = FVector::CrossProduct(Positions[Triangle.Y] - Positions[Triangle.X], Positions[Triangle.Z] - Positions[Triangle.X]).GetSafeNormal();
+			const int32 TriangleIndex = Triangles.Add(Triangle);
+			NormalZ.Add(FMath::Abs(Normal.Z));
+
+			for (int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				const uint32 A = Triangle[Corner];
+				const uint32 B = Triangle[(Corner + 1) % 3];
+				EdgeTriangles.FindOrAdd((uint64(FMath::Min(A, B)) << 32) | FMath::Max(A, B)).Add(TriangleIndex);
+			}
+		}
+
+		for (const TPair<uint64, TArray<int32, TInlineAllocator<2>>>& Edge : EdgeTriangles)
+		{
+			if (Edge.Value.Num() != 2)
+			{
+				continue;
+			}
+
+			int32 TopTriangle = Edge.Value[0];
+			int32 WallTriangle = Edge.Value[1];
+			if (NormalZ[TopTriangle] < NormalZ[WallTriangle])
+			{
+				Swap(TopTriangle, WallTriangle);
+			}
+			if (NormalZ[TopTriangle] < MinTopNormalZ || NormalZ[WallTriangle] > MaxWallNormalZ)
+			{
+				continue;
+			}
+
+			const int32 EdgeA = static_cast<int32>(Edge.Key >> 32);
+			const int32 EdgeB = static_cast<int32>(Edge.Key & 0xFFFFFFFF);
+			const FVector Start = Positions[EdgeA];
+			const FVector End = Positions[EdgeB];
+			const FVector EdgeDelta = End - Start;
+			if (FMath::Abs(EdgeDelta.Z) > 0.1 * EdgeDelta.Size2D())
+			{
+				continue;
+			}
+
+			// The corners opposite the edge tell on which side the top lies and whether the wall hangs below.
+			const auto GetOppositeCorner = [&](int32 TriangleIndex)
+			{
+				const FIntVector& Triangle = Triangles[TriangleIndex];
+				const int32 Corner = (Triangle.X != EdgeA && Triangle.X != EdgeB) ? Triangle.X : ((Triangle.Y != EdgeA && Triangle.Y != EdgeB) ? Triangle.Y : Triangle.Z);
+				return Positions[Corner];
+			};
+
+			const FVector Middle = (Start + End) * 0.5;
+			if (GetOppositeCorner(WallTriangle).Z >= Middle.Z - 1.0)
+			{
+				continue;
+			}
+
+			FVector Normal = FVector(-EdgeDelta.Y, EdgeDelta.X, 0.0).GetSafeNormal();
+			if (FVector::DotProduct(Normal, GetOppositeCorner(TopTriangle) - Middle) > 0.0)
+			{
+				Normal = -Normal;
+			}
+
+			OutEdges.Add({ Start, End, Normal });
+		}
+	}
+}
+#endif
+
+UChaosBakeLedgesCommandlet::UChaosBakeLedgesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UChaosBakeLedgesCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens, Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	const FString* MapsParam = ParamValues.Find(TEXT("Maps"));
+	if (!MapsParam)
+	{
+		UE_LOG(LogChaosLedgeBake, Error, TEXT("Usage: -run=ChaosBakeLedges -Maps=/Game/Map1+/Game/Map2 [-Character=<class path>] [-CellSize=400] [-SegmentLength=100]"));
+		return 1;
+	}
+
+	// The ledges have to match what the player's mantle accepts.
+	TSubclassOf<AChaosCharacter> CharacterClass = AChaosCharacter::StaticClass();
+	if (const FString* CharacterParam = ParamValues.Find(TEXT("Character")))
+	{
+		CharacterClass = LoadClass<AChaosCharacter>(nullptr, **CharacterParam);
+		if (!CharacterClass)
+		{
+			UE_LOG(LogChaosLedgeBake, Error, TEXT("'%s' is not a ChaosCharacter class."), **CharacterParam);
+			return 1;
+		}
+	}
+
+	const AChaosCharacter* CharacterDefaults = CharacterClass->GetDefaultObject<AChaosCharacter>();
+	MinMantleHeight = CharacterDefaults->MinMantleHeight;
+	CapsuleRadius = CharacterDefaults->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	CapsuleHalfHeight = CharacterDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	if (const FString* CellSizeParam = ParamValues.Find(TEXT("CellSize")))
+	{
+		CellSize = FMath::Max(FCString::Atof(**CellSizeParam), 1.f);
+	}
+	if (const FString* SegmentLengthParam = ParamValues.Find(TEXT("SegmentLength")))
+	{
+		SegmentLength = FMath::Max(FCString::Atof(**SegmentLengthParam), 1.f);
+	}
+
+	TArray<FString> PackageNames;
+	MapsParam->ParseIntoArray(PackageNames, TEXT("+"));
+
+	int32 NumFailed = 0;
+	for (const FString& PackageName : PackageNames)
+	{
+		NumFailed += BakeMap(PackageName) ? 0 : 1;
+	}
+	return NumFailed;
+#else
+	UE_LOG(LogChaosLedgeBake, Error, TEXT("Ledges can only be baked in editor builds."));
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+bool UChaosBakeLedgesCommandlet::BakeMap(const FString& PackageName) const
+{
+	UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogChaosLedgeBake, Error, TEXT("'%s' is not a map."), *PackageName);
+		return false;
+	}
+
+	// Loaded maps have no physics scene yet, but the ledges are validated with real scene queries.
+	World->WorldType = EWorldType::Editor;
+	World->AddToRoot();
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.CreatePhysicsScene(true)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	TArray<FChaosLedgeSegment> Segments;
+	CollectLedges(World, Segments);
+
+	// Reuse the index of an earlier bake. It sits at the origin, so the baked world positions are its local ones.
+	AChaosLedgeIndex* LedgeIndex = nullptr;
+	for (TActorIterator<AChaosLedgeIndex> It(World); It; ++It)
+	{
+		if (It->GetLevel() == World->PersistentLevel)
+		{
+			LedgeIndex = *It;
+			break;
+		}
+	}
+	if (!LedgeIndex)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.OverrideLevel = World->PersistentLevel;
+		LedgeIndex = World->SpawnActor<AChaosLedgeIndex>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	}
+	LedgeIndex->SetActorTransform(FTransform::Identity);
+
+	const int32 NumSegments = Segments.Num();
+	LedgeIndex->SetLedges(MoveTemp(Segments), CellSize);
+	Package->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension());
+	const bool bSaved = UPackage::SavePackage(Package, World, *Filename, SaveArgs);
+
+	if (bSaved)
+	{
+		UE_LOG(LogChaosLedgeBake, Display, TEXT("Baked %d ledge segments into '%s'."), NumSegments, *PackageName);
+	}
+	else
+	{
+		UE_LOG(LogChaosLedgeBake, Error, TEXT("Failed to save '%s'."), *Filename);
+	}
+
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(RF_NoFlags);
+	return bSaved;
+}
+
+void UChaosBakeLedgesCommandlet::CollectLedges(UWorld* World, TArray<FChaosLedgeSegment>& OutSegments) const
+{
+	TArray<ChaosLedgeBake::FLedgeEdge> Edges;
+
+	// Only geometry that never moves and blocks the mantle traces can carry baked ledges.
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		It->ForEachComponent<UStaticMeshComponent>(false, [&](const UStaticMeshComponent* Component)
+		{
+			if (Component->Mobility != EComponentMobility::Static || !Component->IsQueryCollisionEnabled() || Component->GetCollisionResponseToChannel(ECC_WorldStatic) != ECR_Block)
+			{
+				return;
+			}
+
+			if (const UInstancedStaticMeshComponent* Instances = Cast<UInstancedStaticMeshComponent>(Component))
+			{
+				for (int32 InstanceIndex = 0; InstanceIndex < Instances->GetInstanceCount(); ++InstanceIndex)
+				{
+					FTransform InstanceTransform;
+					Instances->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+					ChaosLedgeBake::ExtractMeshLedges(Component->GetStaticMesh(), InstanceTransform, Edges);
+				}
+			}
+			else
+			{
+				ChaosLedgeBake::ExtractMeshLedges(Component->GetStaticMesh(), Component->GetComponentTransform(), Edges);
+			}
+		});
+	}
+
+	// Validate each edge piece by piece and merge the accepted runs. The landing check uses the runtime probe's
+	// geometry from ChaosLedges; the drop check has no runtime counterpart and only keeps steps out of the index.
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ChaosLedgeBake), false);
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+	for (const ChaosLedgeBake::FLedgeEdge& Edge : Edges)
+	{
+		const int32 NumPieces = FMath::Max(1, FMath::CeilToInt32(FVector::Dist(Edge.Start, Edge.End) / SegmentLength));
+		bool bExtendLast = false;
+		for (int32 Piece = 0; Piece < NumPieces; ++Piece)
+		{
+			const FVector PieceStart = FMath::Lerp(Edge.Start, Edge.End, static_cast<double>(Piece) / NumPieces);
+			const FVector PieceEnd = FMath::Lerp(Edge.Start, Edge.End, static_cast<double>(Piece + 1) / NumPieces);
+			const FVector Middle = (PieceStart + PieceEnd) * 0.5;
+
+			// Lower drops are steps the character simply walks up.
+			const FVector DropStart = Middle + Edge.Normal * 5.f;
+			const bool bTallEnough = !World->LineTraceTestByChannel(DropStart, DropStart - FVector(0.f, 0.f, MinMantleHeight), ECC_WorldStatic, QueryParams);
+
+			// The character has to fit where the mantle puts it.
+			const FVector IntoLedge = -Edge.Normal;
+			const FVector LandingLocation = ChaosLedges::GetLandingLocation(ChaosLedges::GetLedgePoint(Middle, IntoLedge), IntoLedge, CapsuleRadius, CapsuleHalfHeight);
+			const bool bLandingFree = !World->OverlapBlockingTestByChannel(LandingLocation, FQuat::Identity, ECC_WorldStatic, Capsule, QueryParams);
+
+			if (!bTallEnough || !bLandingFree)
+			{
+				bExtendLast = false;
+				continue;
+			}
+
+			if (bExtendLast)
+			{
+				OutSegments.Last().End = PieceEnd;
+			}
+			else
+			{
+				FChaosLedgeSegment& Segment = OutSegments.AddDefaulted_GetRef();
+				Segment.Start = PieceStart;
+				Segment.End = PieceEnd;
+				Segment.Normal = Edge.Normal;
+				bExtendLast = true;
+			}
+		}
+	}
+}
+#endif
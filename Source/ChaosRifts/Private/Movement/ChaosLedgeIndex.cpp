@@ -0,0 +1,174 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Movement/ChaosLedgeIndex.h"
+#include "Movement/ChaosLedgeSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+
+namespace ChaosLedgeIndex
+{
+	/** Orders cells row by row, matching the order of AChaosLedgeIndex::Cells. */
+	static bool CoordLess(const FIntPoint& A, const FIntPoint& B)
+	{
+		return A.Y != B.Y ? A.Y < B.Y : A.X < B.X;
+	}
+}
+
+AChaosLedgeIndex::AChaosLedgeIndex()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	SetHidden(true);
+	SetCanBeDamaged(false);
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void AChaosLedgeIndex::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UChaosLedgeSubsystem* Ledges = GetWorld()->GetSubsystem<UChaosLedgeSubsystem>())
+	{
+		Ledges->RegisterLedgeIndex(this);
+	}
+}
+
+void AChaosLedgeIndex::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UChaosLedgeSubsystem* Ledges = GetWorld()->GetSubsystem<UChaosLedgeSubsystem>())
+	{
+		Ledges->UnregisterLedgeIndex(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AChaosLedgeIndex::SetLedges(TArray<FChaosLedgeSegment>&& InSegments, float InCellSize)
+{
+	Segments = MoveTemp(InSegments);
+	CellSize = FMath::Max(InCellSize, 1.f);
+
+	// Every segment is listed in each cell its 2D bounds touch.
+	TMap<FIntPoint, TArray<int32>> CellMap;
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+	{
+		const FIntPoint MinCoord = GetCellCoord(Segments[SegmentIndex].Start.ComponentMin(Segments[SegmentIndex].End));
+		const FIntPoint MaxCoord = GetCellCoord(Segments[SegmentIndex].Start.ComponentMax(Segments[SegmentIndex].End));
+		for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+		{
+			for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+			{
+				CellMap.FindOrAdd(FIntPoint(X, Y)).Add(SegmentIndex);
+			}
+		}
+	}
+
+	TArray<FIntPoint> Coords;
+	CellMap.GetKeys(Coords);
+	Coords.Sort(&ChaosLedgeIndex::CoordLess);
+
+	Cells.Reset(Coords.Num());
+	CellSegments.Reset();
+	for (const FIntPoint& Coord : Coords)
+	{
+		const TArray<int32>& CellIndices = CellMap.FindChecked(Coord);
+
+		FChaosLedgeCell& Cell = Cells.AddDefaulted_GetRef();
+		Cell.Coord = Coord;
+		Cell.FirstIndex = CellSegments.Num();
+		Cell.NumIndices = CellIndices.Num();
+		CellSegments.Append(CellIndices);
+	}
+}
+
+bool AChaosLedgeIndex::FindLedge(const FVector& WorldOrigin, const FVector& WorldDirection, float MaxDistance, float MinHeight, float MaxHeight, FChaosLedgeHit& OutHit) const
+{
+	// The ledges are stored relative to the actor, so a room moved and turned as a whole keeps its ledges.
+	const FTransform& ActorTransform = GetActorTransform();
+	const FVector Origin = ActorTransform.InverseTransformPosition(WorldOrigin);
+	const FVector Direction = ActorTransform.InverseTransformVectorNoScale(WorldDirection);
+
+	const FVector2D RayOrigin(Origin);
+	const FVector2D RayDirection = FVector2D(Direction).GetSafeNormal();
+	if (RayDirection.IsZero())
+	{
+		return false;
+	}
+
+	const FVector RayEnd = Origin + FVector(RayDirection, 0.f) * MaxDistance;
+	const FIntPoint MinCoord = GetCellCoord(Origin.ComponentMin(RayEnd));
+	const FIntPoint MaxCoord = GetCellCoord(Origin.ComponentMax(RayEnd));
+
+	bool bFound = false;
+	OutHit.Distance = MaxDistance;
+
+	for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+	{
+		for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+		{
+			const FChaosLedgeCell* Cell = FindCell(FIntPoint(X, Y));
+			if (!Cell)
+			{
+				continue;
+			}
+
+			for (int32 Index = Cell->FirstIndex; Index < Cell->FirstIndex + Cell->NumIndices; ++Index)
+			{
+				const FChaosLedgeSegment& Segment = Segments[CellSegments[Index]];
+
+				// Only walls the ray runs into can be climbed.
+				if (FVector2D::DotProduct(RayDirection, FVector2D(Segment.Normal)) >= 0.f)
+				{
+					continue;
+				}
+
+				// Intersect the ray with the segment on the horizontal plane.
+				const FVector2D SegmentStart(Segment.Start);
+				const FVector2D SegmentDelta = FVector2D(Segment.End) - SegmentStart;
+				const double Denominator = FVector2D::CrossProduct(RayDirection, SegmentDelta);
+				if (FMath::IsNearlyZero(Denominator))
+				{
+					continue;
+				}
+
+				const FVector2D ToSegment = SegmentStart - RayOrigin;
+				const double RayDistance = FVector2D::CrossProduct(ToSegment, SegmentDelta) / Denominator;
+				const double SegmentAlpha = FVector2D::CrossProduct(ToSegment, RayDirection) / Denominator;
+				if (RayDistance < 0.0 || RayDistance > OutHit.Distance || SegmentAlpha < 0.0 || SegmentAlpha > 1.0)
+				{
+					continue;
+				}
+
+				const FVector Point = FMath::Lerp(Segment.Start, Segment.End, SegmentAlpha);
+				const double Height = Point.Z - Origin.Z;
+				if (Height < MinHeight || Height > MaxHeight)
+				{
+					continue;
+				}
+
+				bFound = true;
+				OutHit.Point = Point;
+				OutHit.Normal = Segment.Normal;
+				OutHit.Distance = static_cast<float>(RayDistance);
+			}
+		}
+	}
+
+	if (bFound)
+	{
+		OutHit.Point = ActorTransform.TransformPosition(OutHit.Point);
+		OutHit.Normal = ActorTransform.TransformVectorNoScale(OutHit.Normal);
+	}
+	return bFound;
+}
+
+FIntPoint AChaosLedgeIndex::GetCellCoord(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+const FChaosLedgeCell* AChaosLedgeIndex::FindCell(const FIntPoint& Coord) const
+{
+	const int32 CellIndex = Algo::LowerBoundBy(Cells, Coord, &FChaosLedgeCell::Coord, &ChaosLedgeIndex::CoordLess);
+	return Cells.IsValidIndex(CellIndex) && Cells[CellIndex].Coord == Coord ? &Cells[CellIndex] : nullptr;
+}
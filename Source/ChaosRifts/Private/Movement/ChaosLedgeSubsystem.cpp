@@ -0,0 +1,32 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "Movement/ChaosLedgeSubsystem.h"
+
+void UChaosLedgeSubsystem::RegisterLedgeIndex(AChaosLedgeIndex* LedgeIndex)
+{
+	if (IsValid(LedgeIndex))
+	{
+		LedgeIndices.AddUnique(LedgeIndex);
+	}
+}
+
+void UChaosLedgeSubsystem::UnregisterLedgeIndex(AChaosLedgeIndex* LedgeIndex)
+{
+	LedgeIndices.RemoveSwap(LedgeIndex, EAllowShrinking::No);
+}
+
+bool UChaosLedgeSubsystem::FindLedge(const FVector& Origin, const FVector& Direction, float MaxDistance, float MinHeight, float MaxHeight, FChaosLedgeHit& OutHit) const
+{
+	// Rooms may touch or overlap at their doors, so the closest ledge over all indices wins.
+	bool bFound = false;
+	for (const TWeakObjectPtr<AChaosLedgeIndex>& LedgeIndex : LedgeIndices)
+	{
+		FChaosLedgeHit Hit;
+		if (LedgeIndex.IsValid() && LedgeIndex->FindLedge(Origin, Direction, MaxDistance, MinHeight, MaxHeight, Hit) && (!bFound || Hit.Distance < OutHit.Distance))
+		{
+			OutHit = Hit;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
@@ -0,0 +1,190 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "UI/ChaosHealthBarSubsystem.h"
+#include "UI/ChaosHealthBarWidget.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+
+void UChaosHealthBarSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UChaosHealthBarSubsystem::HandleWorldPostActorTick);
+}
+
+void UChaosHealthBarSubsystem::SetupHealthBars(APlayerController* InOwningController, TSubclassOf<UChaosHealthBarWidget> WidgetClass, int32 PoolSize, float InMaxDistance, const FVector& InWorldOffset)
+{
+	if (!InOwningController || !InOwningController->IsLocalController() || !WidgetClass || OwningController.IsValid())
+	{
+		return;
+	}
+
+	OwningController = InOwningController;
+	MaxDistance = InMaxDistance;
+	WorldOffset = InWorldOffset;
+
+	// The whole pool is created up front, so showing a health bar never creates a widget.
+	WidgetPool.Reset(PoolSize);
+	for (int32 Index = 0; Index < PoolSize; ++Index)
+	{
+		if (UChaosHealthBarWidget* Widget = CreateWidget<UChaosHealthBarWidget>(InOwningController, WidgetClass))
+		{
+			Widget->SetVisibility(ESlateVisibility::Collapsed);
+			Widget->SetAlignmentInViewport(FVector2D(0.5f, 1.f));
+			Widget->AddToPlayerScreen();
+			WidgetPool.Add(Widget);
+		}
+	}
+}
+
+void UChaosHealthBarSubsystem::SetHealthBarRequested(AChaosEnemy* Enemy, bool bRequested)
+{
+	if (!Enemy)
+	{
+		return;
+	}
+
+	if (bRequested)
+	{
+		RequestingEnemies.AddUnique(Enemy);
+		return;
+	}
+
+	RequestingEnemies.RemoveSingleSwap(Enemy, EAllowShrinking::No);
+	for (UChaosHealthBarWidget* Widget : WidgetPool)
+	{
+		if (Widget->GetTargetEnemy() == Enemy)
+		{
+			ReleaseWidget(Widget);
+		}
+	}
+}
+
+void UChaosHealthBarSubsystem::NotifyHealthChanged(AChaosEnemy* Enemy)
+{
+	for (UChaosHealthBarWidget* Widget : WidgetPool)
+	{
+		if (Widget->GetTargetEnemy() == Enemy)
+		{
+			Widget->RefreshHealth();
+		}
+	}
+}
+
+int32 UChaosHealthBarSubsystem::GetNumShownHealthBars() const
+{
+	int32 NumShown = 0;
+	for (const UChaosHealthBarWidget* Widget : WidgetPool)
+	{
+		NumShown += Widget->GetTargetEnemy() != nullptr;
+	}
+	return NumShown;
+}
+
+void UChaosHealthBarSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && !WidgetPool.IsEmpty())
+	{
+		UpdateHealthBars();
+	}
+}
+
+void UChaosHealthBarSubsystem::UpdateHealthBars()
+{
+	const APlayerController* Controller = OwningController.Get();
+	const ULocalPlayer* LocalPlayer = Controller ? Controller->GetLocalPlayer() : nullptr;
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer || !LocalPlayer->ViewportClient || !LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		return;
+	}
+
+	// One view-projection matrix for all enemies, instead of rebuilding the view for every single projection.
+	const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+	const FVector ViewOrigin = ProjectionData.ViewOrigin;
+	const double MaxDistanceSquared = FMath::Square(static_cast<double>(MaxDistance));
+
+	Candidates.Reset();
+	for (int32 Index = RequestingEnemies.Num() - 1; Index >= 0; --Index)
+	{
+		AChaosEnemy* Enemy = RequestingEnemies[Index].Get();
+		if (!Enemy)
+		{
+			RequestingEnemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const FVector WorldLocation = Enemy->GetActorLocation() + WorldOffset;
+		const double DistanceSquared = FVector::DistSquared(WorldLocation, ViewOrigin);
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+		if (FSceneView::ProjectWorldToScreen(WorldLocation, ViewRect, ViewProjectionMatrix, ScreenPosition)
+			&& ViewRect.Contains(FIntPoint(FMath::FloorToInt32(ScreenPosition.X), FMath::FloorToInt32(ScreenPosition.Y))))
+		{
+			Candidates.Add({ Enemy, ScreenPosition, DistanceSquared });
+		}
+	}
+
+	// Only the closest enemies get a health bar.
+	if (Candidates.Num() > WidgetPool.Num())
+	{
+		Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+		Candidates.SetNum(WidgetPool.Num(), EAllowShrinking::No);
+	}
+
+	// Release the widgets of enemies that dropped out, so they can be reused below.
+	for (UChaosHealthBarWidget* Widget : WidgetPool)
+	{
+		const AChaosEnemy* TargetEnemy = Widget->GetTargetEnemy();
+		if (TargetEnemy && !Candidates.ContainsByPredicate([TargetEnemy](const FCandidate& Candidate) { return Candidate.Enemy == TargetEnemy; }))
+		{
+			ReleaseWidget(Widget);
+		}
+	}
+
+	// Enemies keep their widget; the others take a free one. There are never more candidates than widgets.
+	for (const FCandidate& Candidate : Candidates)
+	{
+		TObjectPtr<UChaosHealthBarWidget>* AssignedWidget = WidgetPool.FindByPredicate([&Candidate](const UChaosHealthBarWidget* Widget) { return Widget->GetTargetEnemy() == Candidate.Enemy; });
+		if (!AssignedWidget)
+		{
+			AssignedWidget = WidgetPool.FindByPredicate([](const UChaosHealthBarWidget* Widget) { return Widget->GetTargetEnemy() == nullptr; });
+			(*AssignedWidget)->SetTargetEnemy(Candidate.Enemy);
+			(*AssignedWidget)->SetVisibility(ESlateVisibility::HitTestInvisible);
+		}
+		(*AssignedWidget)->SetPositionInViewport(Candidate.ScreenPosition);
+	}
+}
+
+void UChaosHealthBarSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	for (UChaosHealthBarWidget* Widget : WidgetPool)
+	{
+		Widget->RemoveFromParent();
+	}
+	WidgetPool.Reset();
+	RequestingEnemies.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UChaosHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UChaosHealthBarSubsystem::ReleaseWidget(UChaosHealthBarWidget* Widget)
+{
+	Widget->SetTargetEnemy(nullptr);
+	Widget->SetVisibility(ESlateVisibility::Collapsed);
+}
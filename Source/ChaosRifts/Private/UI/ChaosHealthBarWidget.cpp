@@ -0,0 +1,26 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#include "UI/ChaosHealthBarWidget.h"
+#include "Characters/Enemy/ChaosEnemy.h"
+#include "Components/ChaosAttributes.h"
+
+void UChaosHealthBarWidget::SetTargetEnemy(AChaosEnemy* NewTargetEnemy)
+{
+	if (TargetEnemy.Get() == NewTargetEnemy)
+	{
+		return;
+	}
+
+	TargetEnemy = NewTargetEnemy;
+	OnTargetEnemyChanged(NewTargetEnemy);
+	RefreshHealth();
+}
+
+void UChaosHealthBarWidget::RefreshHealth()
+{
+	const AChaosEnemy* Enemy = TargetEnemy.Get();
+	if (const UChaosAttributes* Attributes = Enemy ? Enemy->GetAttributes() : nullptr)
+	{
+		OnHealthChanged(Attributes->GetHealth(), Attributes->GetMaxHealth());
+	}
+}
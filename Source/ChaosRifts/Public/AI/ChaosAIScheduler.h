@@ -0,0 +1,96 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ChaosAIScheduler.generated.h"
+
+class AChaosEnemy;
+class UStateTreeComponent;
+
+/** What the AI scheduler did during the last frame. */
+USTRUCT(BlueprintType)
+struct FChaosAISchedulerStats
+{
+	GENERATED_BODY()
+
+	/** How many brains were evaluated. */
+	UPROPERTY(BlueprintReadOnly, Category = "Chaos|AI")
+	int32 NumEvaluated = 0;
+
+	/** How many active brains had to wait for a later frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Chaos|AI")
+	int32 Backlog = 0;
+
+	/** The game thread time spent evaluating, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Chaos|AI")
+	float UsedMs = 0.f;
+};
+
+/**
+ * Runs the StateTree brains of all enemies within a fixed per-frame time budget.
+ * The brains do not tick themselves. Each frame the scheduler first evaluates the enemies the tick manager has in
+ * its Full bucket (close to and seen by the player), then continues round-robin through the others until the budget
+ * is used up. Dormant enemies are skipped and do not build up time. Every evaluation receives the time since that
+ * brain was last evaluated, so far enemies simply react a few frames later while the cost per frame stays flat as
+ * enemy counts grow.
+ * The budget can be tuned in the [/Script/ChaosRifts.ChaosAIScheduler] section of DefaultGame.ini; "stat ChaosAI"
+ * shows how it is used.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosAIScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Takes over ticking an enemy's StateTree brain. */
+	void RegisterBrain(AChaosEnemy* Enemy, UStateTreeComponent* Brain);
+
+	/** Stops scheduling an enemy's brain. The brain is left with its own tick disabled. */
+	void UnregisterBrain(AChaosEnemy* Enemy);
+
+	/** Returns what the scheduler did during the last frame. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|AI")
+	FChaosAISchedulerStats GetLastFrameStats() const { return LastFrameStats; }
+
+	/** Returns the number of registered brains. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|AI")
+	int32 GetNumBrains() const { return Entries.Num(); }
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/** The game thread time in milliseconds the round-robin pass may use per frame. Close enemies are always evaluated. */
+	UPROPERTY(Config)
+	float BudgetMs = 1.f;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AChaosEnemy> Enemy;
+		TWeakObjectPtr<UStateTreeComponent> Brain;
+		double LastEvaluationTime = 0.0;
+	};
+
+	/** Ticks a single brain with the time since its last evaluation. */
+	void Evaluate(FEntry& Entry, double Now);
+
+	/** Densely packed entries of all registered brains. */
+	TArray<FEntry> Entries;
+
+	/** Where the round-robin pass continues next frame. */
+	int32 RoundRobinCursor = 0;
+
+	/** Marks the entries already evaluated in the priority pass this frame. */
+	TBitArray<> EvaluatedThisFrame;
+
+	FChaosAISchedulerStats LastFrameStats;
+};
@@ -0,0 +1,116 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "ChaosCrowdSubsystem.generated.h"
+
+class AChaosEnemy;
+
+/**
+ * Crowd level of detail for horde enemies.
+ * Enemies far away from every player do not exist as actors; they are plain data records (position, velocity,
+ * health, state) kept in parallel arrays and moved in one bulk pass per frame. Records that come within
+ * PromoteRadius of a player are promoted to full AChaosEnemy actors taken from the enemy pool, and promoted
+ * enemies that fall behind beyond DemoteRadius are turned back into records. The gap between both radii keeps
+ * enemies from flickering between the two representations.
+ * The radii and budgets can be tuned in the [/Script/ChaosRifts.ChaosCrowdSubsystem] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Adds a horde enemy to the world. Enemies spawning close to a player become actors right away, all others
+	 * start as lightweight records.
+	 * @param EnemyClass The class the enemy is promoted to.
+	 * @param Location The location of the enemy's feet.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	void SpawnCrowdEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location);
+
+	/** Returns the number of enemies currently represented as records. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	int32 GetNumRecords() const { return Locations.Num(); }
+
+	/** Returns the number of crowd enemies currently represented as actors. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	int32 GetNumPromotedEnemies() const { return PromotedEnemies.Num(); }
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/** Records closer than this to a player become actors. */
+	UPROPERTY(Config)
+	float PromoteRadius = 4000.f;
+
+	/** Promoted enemies farther than this from every player become records again. Must be above PromoteRadius. */
+	UPROPERTY(Config)
+	float DemoteRadius = 5500.f;
+
+	/** Records closer than this to a player move towards it; the others stand still. */
+	UPROPERTY(Config)
+	float AggroRadius = 15000.f;
+
+	/** The most records promoted in a single frame, to spread spawning costs over several frames. */
+	UPROPERTY(Config)
+	int32 MaxPromotionsPerFrame = 4;
+
+	/** The most enemies demoted in a single frame. */
+	UPROPERTY(Config)
+	int32 MaxDemotionsPerFrame = 4;
+
+private:
+	/** The states a record can be in. */
+	enum class ERecordState : uint8
+	{
+		Idle,
+		Chasing
+	};
+
+	/** Adds a record. */
+	void AddRecord(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location, const FVector& Velocity, float HealthFraction);
+
+	/** Removes a record. The last record is moved into the freed slot. */
+	void RemoveRecord(int32 RecordIndex);
+
+	/** Moves all records in one pass. */
+	void SimulateRecords(float DeltaTime, TConstArrayView<FVector> PlayerLocations);
+
+	/** Turns the records close to a player into actors. Records that fail to promote stay records. */
+	void PromoteRecords(TConstArrayView<FVector> PlayerLocations);
+
+	/** Turns the promoted enemies far from every player back into records. */
+	void DemoteEnemies(TConstArrayView<FVector> PlayerLocations);
+
+	/** Takes an enemy from the pool (or spawns one) standing on the ground at a record's location. Can return null. */
+	AChaosEnemy* PromoteToActor(TSubclassOf<AChaosEnemy> EnemyClass, const FVector& Location, const FVector& Velocity, float HealthFraction);
+
+	/** Returns the squared distance to the closest player. */
+	static double GetClosestDistanceSquared(const FVector& Location, TConstArrayView<FVector> PlayerLocations, int32* OutPlayerIndex = nullptr);
+
+	//~ The record columns. Index N of every array belongs to the same enemy.
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Speeds;
+	TArray<float> HealthFractions;
+	TArray<ERecordState> States;
+
+	/** The class each record is promoted to. */
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<AChaosEnemy>> Classes;
+
+	/** The crowd enemies currently represented as actors. */
+	TArray<TWeakObjectPtr<AChaosEnemy>> PromotedEnemies;
+};
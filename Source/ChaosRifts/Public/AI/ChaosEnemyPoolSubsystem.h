@@ -0,0 +1,71 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "ChaosEnemyPoolSubsystem.generated.h"
+
+class AChaosEnemy;
+
+/** The dormant enemies of one class. */
+USTRUCT()
+struct FChaosEnemyPoolList
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AChaosEnemy>> Enemies;
+};
+
+/**
+ * Recycles enemies instead of destroying dead ones and spawning new ones for every wave.
+ * Dead enemies are retired into a dormant state together with their weapons, and acquiring an enemy of the same
+ * class reactivates one of them. Only when no dormant enemy is left is a new one spawned. Waves spawn and kill
+ * hundreds of enemies per run, so this removes the SpawnActor/Destroy churn and the garbage it leaves behind.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Returns a living enemy of the given class at the given transform, reusing a dormant one if possible.
+	 * @param EnemyClass The class of the enemy.
+	 * @param SpawnTransform Where to place the enemy.
+	 * @return The enemy, or null if a new one could not be spawned.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	AChaosEnemy* AcquireEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	/** Retires an enemy into the pool. It is hidden and inert until it is acquired again. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	void ReleaseEnemy(AChaosEnemy* Enemy);
+
+	/**
+	 * Spawns enemies straight into the pool, e.g. during a loading screen, so the first wave does not hitch.
+	 * @param EnemyClass The class of the enemies.
+	 * @param Count How many dormant enemies of this class the pool should hold at least.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	void Prewarm(TSubclassOf<AChaosEnemy> EnemyClass, int32 Count);
+
+	/** Returns the number of dormant enemies of a class. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Enemies")
+	int32 GetNumPooledEnemies(TSubclassOf<AChaosEnemy> EnemyClass) const;
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Spawns a new enemy. It runs BeginPlay (and spawns its weapons) right away. */
+	AChaosEnemy* SpawnEnemy(TSubclassOf<AChaosEnemy> EnemyClass, const FTransform& SpawnTransform) const;
+
+	/** The dormant enemies, per class. */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UClass>, FChaosEnemyPoolList> Pools;
+};
@@ -0,0 +1,126 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ChaosEnemyTickManager.generated.h"
+
+class AChaosEnemy;
+
+/** How often a registered enemy is updated, from most to least often. */
+UENUM(BlueprintType)
+enum class EChaosEnemyTickBucket : uint8
+{
+	/** Ticks every frame. Enemies near the player. */
+	Full,
+	/** Ticks at a reduced rate. */
+	Reduced,
+	/** Ticks rarely. Enemies far away or off-screen. */
+	Low,
+	/** Does not tick at all until it becomes relevant again. */
+	Dormant,
+
+	Num UMETA(Hidden)
+};
+
+/** The tick settings of one significance bucket. */
+USTRUCT()
+struct FChaosEnemyTickBucketSettings
+{
+	GENERATED_BODY()
+
+	/** Enemies with a significance distance up to this value fall into the bucket. */
+	UPROPERTY(Config)
+	float MaxDistance = 0.f;
+
+	/** The tick interval in seconds applied to the actor, its movement and its mesh. 0 ticks every frame. */
+	UPROPERTY(Config)
+	float TickInterval = 0.f;
+};
+
+/**
+ * Scores all enemies by their distance to the closest player and whether they were rendered recently, and sorts
+ * them into tick buckets. Each bucket sets the tick interval of the actor, its CharacterMovement and its skeletal
+ * mesh together; the last bucket stops them from ticking altogether. Settings only change when an enemy moves to
+ * another bucket, and the scoring itself runs at a fixed, low rate.
+ * The bucket settings can be tuned in the [/Script/ChaosRifts.ChaosEnemyTickManager] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosEnemyTickManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UChaosEnemyTickManager();
+
+	/** Adds an enemy to the manager. It starts in the Full bucket until it is scored. */
+	void RegisterEnemy(AChaosEnemy* Enemy);
+
+	/** Removes an enemy from the manager and restores its full tick rate. */
+	void UnregisterEnemy(AChaosEnemy* Enemy);
+
+	/** Returns the bucket an enemy is currently in. Unregistered enemies are reported as Full. */
+	EChaosEnemyTickBucket GetEnemyBucket(const AChaosEnemy* Enemy) const;
+
+	/** Returns how many registered enemies are currently in a bucket. */
+	int32 GetNumEnemiesInBucket(EChaosEnemyTickBucket Bucket) const;
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/** The settings of the Full, Reduced and Low buckets. Enemies beyond the last MaxDistance are dormant. */
+	UPROPERTY(Config)
+	FChaosEnemyTickBucketSettings BucketSettings[static_cast<int32>(EChaosEnemyTickBucket::Dormant)];
+
+	/** Enemies that were not rendered recently count as this many times farther away. */
+	UPROPERTY(Config)
+	float OffscreenDistanceScale = 2.f;
+
+	/** How long ago an enemy may have been rendered to still count as visible. */
+	UPROPERTY(Config)
+	float VisibilityTolerance = 0.25f;
+
+	/** The time in seconds between two scoring passes. */
+	UPROPERTY(Config)
+	float EvaluationInterval = 0.2f;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AChaosEnemy> Enemy;
+		TObjectKey<AChaosEnemy> Key;
+		EChaosEnemyTickBucket Bucket = EChaosEnemyTickBucket::Full;
+	};
+
+	/** Scores every enemy and moves those whose bucket changed. */
+	void EvaluateBuckets();
+
+	/** Returns the bucket for a significance distance. */
+	EChaosEnemyTickBucket GetBucketForDistance(float Distance) const;
+
+	/** Applies the tick settings of a bucket to the actor, its movement and its mesh. */
+	void ApplyBucket(AChaosEnemy* Enemy, EChaosEnemyTickBucket Bucket) const;
+
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Densely packed entries of all registered enemies. */
+	TArray<FEntry> Entries;
+
+	/** Maps a registered enemy to its slot in Entries. */
+	TMap<TObjectKey<AChaosEnemy>, int32> EntryIndices;
+
+	/** How many entries are in each bucket. */
+	int32 BucketCounts[static_cast<int32>(EChaosEnemyTickBucket::Num)] = {};
+
+	/** Time left until the next scoring pass. */
+	float TimeUntilEvaluation = 0.f;
+};
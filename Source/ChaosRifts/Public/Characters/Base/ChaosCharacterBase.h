@@ -7,7 +7,46 @@
 #include "Items/Weapons/Weapon.h"
 #include "ChaosCharacterBase.generated.h"
 
+class UAnimSequenceBase;
 class UChaosAttributes;
+class UChaosWeaponComponent;
+
+/** The side a character fights on. Used by combat queries to skip allies. */
+UENUM(BlueprintType)
+enum class EChaosTeam : uint8
+{
+	Neutral,
+	Player,
+	Enemy
+};
+
+/**
+ * The states in which a character needs its actor tick. The actor only ticks while at least one of them is active,
+ * so idle characters cost nothing per frame.
+ */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EChaosTickState : uint8
+{
+	None = 0 UMETA(Hidden),
+	/** The Blueprint implements Event Tick. */
+	Blueprint = 1 << 0,
+	/** Airborne while moving forward, looking for a ledge to mantle. */
+	VaultCheck = 1 << 1,
+	Mantling = 1 << 2
+};
+ENUM_CLASS_FLAGS(EChaosTickState);
+
+/** Reasons that keep a character's actor tick off, whatever its tick states are. */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EChaosTickBlock : uint8
+{
+	None = 0 UMETA(Hidden),
+	/** The character is dormant in a pool. */
+	Pooled = 1 << 0,
+	/** The UChaosEnemyTickManager put the character to sleep. */
+	Dormant = 1 << 1
+};
+ENUM_CLASS_FLAGS(EChaosTickBlock);
 
 // A delegate that is broadcast when a character dies.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDeathDelegate, AChaosCharacterBase*, DeadCharacter);
@@ -49,6 +88,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Character")
 	FORCEINLINE UChaosAttributes* GetAttributes() const { return AttributesComponent; }
 
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Character")
+	FORCEINLINE EChaosTeam GetTeam() const { return Team; }
+
 	//~==============================================================================================
 	//~ Combat Interface
 	//~==============================================================================================
@@ -64,19 +106,69 @@ public:
 
 	UPROPERTY(BlueprintAssignable, Category = "Chaos|Combat")
 	FOnDeathDelegate OnDeath;
+
+	/** Returns the animation whose last frame a corpse is frozen in when it cannot ragdoll. Can be null. */
+	UAnimSequenceBase* GetDeathPose() const { return DeathPose; }
 	
-	/** Returns the currently equipped weapon. */
+	/** Returns the currently equipped weapon. Null when the character uses weapon components. */
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Combat|Weapons")
 	AWeapon* GetCurrentWeapon() const;
+
+	/** Returns the currently equipped weapon component, if the character uses weapon components. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Combat|Weapons")
+	UChaosWeaponComponent* GetCurrentWeaponComponent() const;
+
+	//~==============================================================================================
+	//~ Pooling - Characters can be retired and reused instead of being destroyed and spawned again.
+	//~==============================================================================================
+
+	/**
+	 * Puts the character into a dormant state: hidden, without collision, ticking, movement or AI logic.
+	 * The character keeps its components and weapons, so it can be reactivated later.
+	 */
+	virtual void DeactivateForPool();
+
+	/**
+	 * Brings a pooled character back to life at its current transform: restores attributes, collision,
+	 * movement, mesh physics and weapons to the state of a freshly spawned character.
+	 */
+	virtual void ReactivateFromPool();
+
+	/** Returns whether the character is currently dormant in a pool. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Character")
+	bool IsPooled() const { return bIsPooled; }
+
+	/** Returns whether the character has run out of health. Stays true until it is reactivated from a pool. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Character")
+	bool IsDead() const;
+
+	//~==============================================================================================
+	//~ Tick States - The actor tick runs while some state needs it and nothing blocks it.
+	//~==============================================================================================
+
+	/** Keeps the actor tick off for a reason, or lifts that reason again. */
+	void SetTickBlocked(EChaosTickBlock Block, bool bBlocked);
 	
 protected:
     //~ Begin AActor Interface
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     //~ End AActor Interface
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Chaos|Character")
 	TObjectPtr<UChaosAttributes> AttributesComponent;
 
+	/** The team this character fights for. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Character")
+	EChaosTeam Team = EChaosTeam::Neutral;
+
+	/**
+	 * A death animation for corpses the ragdoll budget has no room for. They are frozen in its last frame instead
+	 * of the pose they died in. Without one, such corpses are tipped over onto their back.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Chaos|Combat")
+	TObjectPtr<UAnimSequenceBase> DeathPose;
+
 	//~==============================================================================================
 	//~ NEW WEAPON SYSTEM PROPERTIES
 	//~==============================================================================================
@@ -85,6 +177,17 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Chaos|Combat|Weapons")
 	TArray<FWeaponLoadoutInfo> DefaultWeaponLoadout;
 
+	/**
+	 * If true, the loadout is created as UChaosWeaponComponents on this character instead of spawning an AWeapon
+	 * actor per entry. The components take their mesh and combat settings from the WeaponClass defaults.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Chaos|Combat|Weapons")
+	bool bUseWeaponComponents = false;
+
+	/** The array containing the RUNTIME INSTANCES of the weapon components, if bUseWeaponComponents is set. */
+	UPROPERTY(BlueprintReadOnly, Category = "Chaos|Combat|Weapons")
+	TArray<TObjectPtr<UChaosWeaponComponent>> WeaponComponents;
+
 	/** The array containing the RUNTIME INSTANCES of the spawned weapons. */
 	UPROPERTY(BlueprintReadOnly, Category = "Chaos|Combat|Weapons")
 	TArray<TObjectPtr<AWeapon>> Weapons;
@@ -93,7 +196,7 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Chaos|Combat|Weapons")
 	TObjectPtr<AWeapon> CurrentWeapon;
 	
-	/** The index of the currently equipped weapon in the 'Weapons' and 'DefaultWeaponLoadout' arrays. */
+	/** The index of the currently equipped weapon in the 'Weapons' (or 'WeaponComponents') and 'DefaultWeaponLoadout' arrays. */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Chaos|Combat|Weapons")
 	int32 CurrentWeaponIndex;
 	
@@ -122,12 +225,94 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Combat|Weapons")
 	void SwapToPreviousWeapon();
 
+	//~==============================================================================================
+	//~ Cooldowns - Kept by the world's UChaosCooldownSubsystem, keyed by this character.
+	//~==============================================================================================
+
+	/** Returns whether one of this character's cooldowns is ready. Always true in worlds without cooldowns. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Cooldowns")
+	bool IsCooldownReady(FName CooldownId) const;
+
+	/**
+	 * Starts (or restarts) one of this character's cooldowns.
+	 * @param OnExpired Optionally executed once the cooldown has run out.
+	 */
+	void StartCooldown(FName CooldownId, float Duration, FSimpleDelegate OnExpired = FSimpleDelegate());
+
+	/** Stops one of this character's cooldowns without executing its callback. */
+	void CancelCooldown(FName CooldownId);
+
+	/** Marks a state as needing the actor tick, or as no longer needing it. */
+	void SetTickState(EChaosTickState State, bool bActive);
+
+	/** Returns whether a state currently needs the actor tick. */
+	bool HasTickState(EChaosTickState State) const { return EnumHasAnyFlags(TickStates, State); }
+
+	/** Makes the next weapon attachment resolve its targets again. Call after adding or removing attach components. */
+	void InvalidateWeaponAttachTargets() { WeaponAttachTargets.Reset(); }
+
+	/** Called after the character was reactivated from a pool, to reset Blueprint state. */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Chaos|Character")
+	void OnReactivatedFromPool();
+
 private:
+	/** Bound to the attributes' OnHealthDepleted delegate. Kills the character. */
+	UFUNCTION()
+	void HandleHealthDepleted(UChaosAttributes* DepletedAttributes);
+
+	/** Where a weapon attaches: a scene component of this character, or else a socket on its mesh. */
+	struct FWeaponAttachTarget
+	{
+		TWeakObjectPtr<USceneComponent> Component;
+		FName SocketName;
+	};
+
+	/** The resolved attach targets of one DefaultWeaponLoadout entry. */
+	struct FWeaponAttachTargets
+	{
+		FWeaponAttachTarget Sheathed;
+		FWeaponAttachTarget Equipped;
+	};
+
 	/**
-	 * Helper function to attach a weapon to a specified socket.
-	 * It intelligently searches for a USceneComponent first, then falls back to a skeletal mesh socket.
-	 * @param WeaponToAttach The weapon actor to attach.
-	 * @param SocketName The name of the SceneComponent or skeletal socket.
+	 * Helper function to attach a weapon to the sheathed or equipped target of its loadout entry.
+	 * Uses the cached attach targets and rebuilds them if a cached component has gone away.
+	 * @param WeaponToAttach The root of the weapon actor, or the weapon component.
+	 * @param LoadoutIndex The weapon's index in DefaultWeaponLoadout.
+	 * @param bEquipped Whether to attach to the equipped target instead of the sheathed one.
 	 */
-	void AttachWeaponToSocket(AWeapon* WeaponToAttach, const FName& SocketName);
+	void AttachWeapon(USceneComponent* WeaponToAttach, int32 LoadoutIndex, bool bEquipped);
+
+	/** Returns the number of weapons, whichever way they are represented. */
+	int32 GetNumWeapons() const;
+
+	/** Returns the component that carries a weapon: the root of its actor or its weapon component. */
+	USceneComponent* GetWeaponRoot(int32 WeaponIndex) const;
+
+	/** Hides or shows a weapon, whichever way it is represented. */
+	void SetWeaponHidden(int32 WeaponIndex, bool bHidden);
+
+	/**
+	 * Resolves the socket names of every loadout entry, searching for a USceneComponent with the name first
+	 * and falling back to a skeletal mesh socket.
+	 */
+	void BuildWeaponAttachTargets();
+
+	/** The attach targets of each DefaultWeaponLoadout entry, so equipping does not search the components. */
+	TArray<FWeaponAttachTargets> WeaponAttachTargets;
+
+	/** Puts the ragdolled (or frozen) mesh back onto the capsule and lets it animate again. */
+	void ResetMeshPhysics();
+
+	/** The collision settings from BeginPlay, restored when a pooled character is reused. */
+	ECollisionEnabled::Type DefaultCapsuleCollision = ECollisionEnabled::QueryAndPhysics;
+	ECollisionEnabled::Type DefaultMeshCollision = ECollisionEnabled::QueryOnly;
+
+	bool bIsPooled = false;
+
+	/** Turns the actor tick on or off to match the tick states and blocks. */
+	void UpdateActorTick();
+
+	EChaosTickState TickStates = EChaosTickState::None;
+	EChaosTickBlock TickBlocks = EChaosTickBlock::None;
 };
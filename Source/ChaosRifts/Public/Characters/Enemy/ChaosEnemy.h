@@ -4,9 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Characters/Base/ChaosCharacterBase.h"
-#include "Components/WidgetComponent.h" // For displaying UI widgets above the enemy
+#include "Components/ChaosAttributes.h" // For EChaosAttribute
 #include "ChaosEnemy.generated.h"
 
+class UStateTreeComponent;
+
 /**
  * Base class for all AI-controlled enemies in ChaosRifts.
  * Inherits core attributes and combat logic from AChaosCharacterBase.
@@ -21,8 +23,14 @@ public:
 
 	//~ Begin AActor Interface
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	//~ End AActor Interface
 
+	//~ Begin AChaosCharacterBase Interface
+	virtual void DeactivateForPool() override;
+	virtual void ReactivateFromPool() override;
+	//~ End AChaosCharacterBase Interface
+
 protected:
 	//~==============================================================================================
 	//~ Combat - Overrides for base combat behavior
@@ -31,19 +39,32 @@ protected:
 	/** Overrides the Die_Implementation from AChaosCharacterBase to handle enemy specific death logic. */
 	virtual void Die_Implementation() override;
 
+	/** How long the body stays in the world after death before it is returned to the enemy pool (or destroyed). */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat", meta = (ClampMin = "0.0"))
+	float CorpseLifeSpan = 5.f;
+
 	//~==============================================================================================
-	//~ UI - Components for displaying health bars etc.
+	//~ UI - Health bars are drawn by the UChaosHealthBarSubsystem.
 	//~==============================================================================================
 
-	/** Widget component for displaying the enemy's health bar above their head. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Chaos|UI", meta = (AllowPrivateAccess = "true"))
-	TObjectPtr<UWidgetComponent> HealthBarWidgetComponent;
-
 	/**
-	 * Sets the visibility of the health bar widget.
-	 * Can be used to hide it when the enemy is full health or far away.
+	 * Requests or withdraws a health bar for this enemy.
+	 * Whether a requested health bar is actually shown depends on the enemy's distance and the health bar budget.
 	 * @param bVisible Whether the health bar should be visible.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Chaos|UI")
 	void SetHealthBarVisibility(bool bVisible);
+
+private:
+	/** Hands the dead enemy to the enemy pool for reuse. */
+	void ReturnToPool();
+
+	FTimerHandle TimerHandle_ReturnToPool;
+
+	/** Returns the StateTree brain of our AI controller, if it runs one. */
+	UStateTreeComponent* FindStateTreeBrain() const;
+
+	/** Reacts to coalesced attribute changes, e.g. to show the health bar when the enemy got hurt. */
+	UFUNCTION()
+	void HandleAttributeChanged(UChaosAttributes* Attributes, EChaosAttribute Attribute, float OldValue, float NewValue);
 };
@@ -8,6 +8,20 @@
 
 class UAnimMontage;
 
+/** How a melee enemy finds the characters hit by its attack. */
+UENUM(BlueprintType)
+enum class EChaosMeleeQueryMode : uint8
+{
+	// Ask the world's target index for hostile candidates and test their capsules against the attack.
+	// Does not touch the physics scene.
+	TargetIndex,
+	// Sweep a sphere through the physics scene on ECC_Pawn.
+	Sweep,
+	// Like Sweep, but submitted as an asynchronous query batched with all other attacks of the frame.
+	// The damage is applied one frame later.
+	AsyncSweep
+};
+
 /**
  * Base class for AI-controlled melee enemies.
  * Implements a basic melee attack suitable for AI.
@@ -52,11 +66,14 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat")
 	float MeleeAttackRadius = 50.f;
 
-private:
-	/** Controls whether the enemy can attack to prevent spamming. */
-	bool bCanAttack = true;
-	FTimerHandle TimerHandle_AttackCooldown;
+	/** How the characters hit by the melee attack are found. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat")
+	EChaosMeleeQueryMode MeleeQueryMode = EChaosMeleeQueryMode::TargetIndex;
 
-	/** Resets the attack cooldown for the enemy. */
-	void ResetAttackCooldown();
+private:
+	/**
+	 * Collects all characters hit by a sphere of MeleeAttackRadius moved from Start to End.
+	 * @param OutHitCharacters Receives the hit characters. The array is reset first.
+	 */
+	void FindMeleeTargets(const FVector& Start, const FVector& End, TArray<AChaosCharacterBase*>& OutHitCharacters) const;
 };
@@ -4,7 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "Characters/Base/ChaosCharacterBase.h"
+#include "Combat/ChaosProjectileSubsystem.h"
 #include "Logging/LogMacros.h"
+#include "WorldCollision.h"
 #include "ChaosCharacter.generated.h"
 
 class USpringArmComponent;
@@ -28,6 +30,14 @@ enum class EMantleState : uint8
 	PushingForward
 };
 
+/** The sub-modes the player uses with MOVE_Custom. */
+UENUM(BlueprintType)
+enum class EChaosCustomMovementMode : uint8
+{
+	/** Driven by the mantle trajectory; the movement component neither moves nor sweeps the capsule. */
+	Mantle
+};
+
 /**
  * The player-controlled character. Inherits shared functionality from AChaosCharacterBase
  * and adds player-specific logic like input and camera control.
@@ -37,6 +47,9 @@ class AChaosCharacter : public AChaosCharacterBase
 {
 	GENERATED_BODY()
 
+	/** Bakes ledges matching this character's mantle settings. */
+	friend class UChaosBakeLedgesCommandlet;
+
 public:
 	AChaosCharacter();
 
@@ -66,6 +79,10 @@ public:
 	void DisableWeaponHitDetection();
 
 protected:
+	//~ Begin UObject Interface
+	virtual void PostLoad() override;
+	//~ End UObject Interface
+
 	//~ Begin AActor Interface
 	virtual void BeginPlay() override;
 	virtual void Tick(float DeltaTime) override;
@@ -75,6 +92,11 @@ protected:
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 	//~ End APawn Interface
 
+	//~ Begin ACharacter Interface
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+	virtual void MoveBlockedBy(const FHitResult& Impact) override;
+	//~ End ACharacter Interface
+
 	// Overriding the Die_Implementation from AChaosCharacterBase for player-specific death logic.
 	// We mark it as BlueprintNativeEvent because the base class does, and it's good practice
 	// to keep the override consistent, even if its main use here is to trigger Game Over.
@@ -121,6 +143,7 @@ protected: // Changed to protected for easier access in Blueprint subclasses if
 
 	// --- Input Handlers ---
 	void Move(const FInputActionValue& Value);
+	void StopMove(const FInputActionValue& Value);
 	void Look(const FInputActionValue& Value);
 	void StartDash();
 	
@@ -183,6 +206,10 @@ protected: // Changed to protected for easier access in Blueprint subclasses
     UPROPERTY(EditDefaultsOnly, Category = "Chaos|Movement|Mantle")
     float MantleFastSpeedThreshold = 600.f;
 
+	// A failed mantle probe is not repeated until the character moved farther than this or turned away.
+	UPROPERTY(EditDefaultsOnly, Category = "Chaos|Movement|Mantle", meta = (ClampMin = "0.0"))
+	float MantleProbeCacheDistance = 20.f;
+
     // --- Animation Montages ---
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Animation") // Changed to BlueprintReadOnly
     TObjectPtr<UAnimMontage> DashMontage;
@@ -206,9 +233,13 @@ protected: // Changed to protected for easier access in Blueprint subclasses
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat")
 	float SpellChaosCost = 25.f;
 
-	// Projectile class to spawn for spells
+	// The projectile fired by spells. Its visual class is what used to be spawned as the spell projectile actor.
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat")
-	TSubclassOf<AActor> SpellProjectileClass;
+	FChaosProjectileSpec SpellProjectile;
+
+	// The projectile actor class spells used to spawn. Moved into SpellProjectile.VisualClass on load.
+	UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Use SpellProjectile.VisualClass instead."))
+	TSubclassOf<AActor> SpellProjectileClass_DEPRECATED;
 
 	// Maximum time after an attack completes to register a combo input
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Combat")
@@ -216,50 +247,92 @@ protected: // Changed to protected for easier access in Blueprint subclasses
 	
 private:
 	// --- Dash System ---
-	void ResetDashCooldown();
+	// Dash readiness and the post-dash speed boost are cooldowns in the UChaosCooldownSubsystem.
 	void ApplyPostDashSpeedBoost();
 	void ResetMovementSpeed();
-	
-	bool bCanDash = true;
-	FTimerHandle TimerHandle_DashCooldown;
-	FTimerHandle TimerHandle_PostDashSpeed;
 
 	// --- Mantle System ---
+	// The mantle probe runs as a chain of asynchronous traces: each stage is queued in one frame and its results
+	// are consumed in the next, where they decide whether the following stage is queued.
+	enum class EMantleProbeStage : uint8
+	{
+		Idle,
+		Wall,         // Front and upper line traces: is there a wall with free space above it?
+		Ledge,        // Downward line trace onto the top of the wall.
+		LandingSpace  // Capsule overlap at the landing location.
+	};
+
+	struct FMantleProbe
+	{
+		EMantleProbeStage Stage = EMantleProbeStage::Idle;
+		FTraceHandle Handles[2];
+		FVector Origin = FVector::ZeroVector;
+		FVector Forward = FVector::ForwardVector;
+		FVector WallPoint = FVector::ZeroVector;
+		FVector LedgePoint = FVector::ZeroVector;
+		FVector LandingLocation = FVector::ZeroVector;
+		TWeakObjectPtr<UPrimitiveComponent> Wall;
+	};
+
+	// Where and against which wall the last probe failed. Cleared by a successful mantle.
+	struct FMantleProbeCache
+	{
+		bool bValid = false;
+		FVector Location = FVector::ZeroVector;
+		FVector Forward = FVector::ForwardVector;
+		TWeakObjectPtr<UPrimitiveComponent> Wall;
+		bool bHitWall = false;
+	};
+
+	/** Turns the VaultCheck tick state on while a mantle could start. Called when its inputs change. */
+	void UpdateVaultCheckTickState();
 	void TickVaultCheck(float DeltaTime);
+	void StartMantleProbe();
+	void AdvanceMantleProbe();
+	void FailMantleProbe();
+	bool IsMantleProbeCached() const;
+
+	FMantleProbe MantleProbe;
+	FMantleProbeCache MantleProbeCache;
+	// The mantle is planned in PerformMantle as a reach leg up to the ledge and a push leg onto it, then sampled by
+	// elapsed time, so it plays the same at any frame rate.
+	struct FMantleTrajectory
+	{
+		FVector Start = FVector::ZeroVector;
+		FVector Ledge = FVector::ZeroVector;
+		FVector Landing = FVector::ZeroVector;
+		float Speed = 1.f;
+		float ReachDuration = 0.f;
+		float PushDuration = 0.f;
+		float Time = 0.f;
+	};
+
 	void PerformMantle(const FVector& LandingTarget, const FVector& LedgePosition);
 	void TickMantle(float DeltaTime);
 	void EndMantle();
-	void ResetVaultCooldown();
 	
 	bool bIsVaulting = false;
-	bool bCanCheckVault = true;
-	float MantleLerpSpeed = MantleLerpSpeedNormal;
-	FVector MantleTargetLocation;
-	FVector MantleLedgeLocation;
+	FMantleTrajectory MantleTrajectory;
 	EMantleState CurrentMantleState = EMantleState::None;
     TObjectPtr<UAnimMontage> CurrentMantleMontage;
+	// Whether the capsule generated overlap events before the mantle suspended them.
+	bool bMantleDeferredOverlaps = false;
 	
 	float ForwardInputValue = 0.f;
-	float DefaultGravityScale = 1.f;
-	FTimerHandle TimerHandle_VaultCooldown;
 
 	// Controls whether the character can attack
 	bool bCanAttack = true; 
 	
 	// --- Melee Combo System ---
-	bool bInComboWindow = false; 
+	// The combo window is a cooldown; the next attack continues the combo while it is running.
 	int32 CurrentComboIndex = 0; 
-	FTimerHandle TimerHandle_ComboWindow;
 
 	void ResetCombo();
 	UFUNCTION()
 	void OnAttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 	void ResetAttackCooldown();
 	
-	// Controls whether the character can cast a spell
-	bool bCanCastSpell = true;
-	FTimerHandle TimerHandle_SpellCastCooldown;
-	void ResetSpellCastCooldown(); // Added: Function to reset spell cast cooldown
+	// Spell casting readiness is a cooldown as long as the cast montage.
 
 	// A specific handler for player death, matching the OnDeath delegate signature.
 	UFUNCTION() // UFUNCTION is required for delegates to bind successfully
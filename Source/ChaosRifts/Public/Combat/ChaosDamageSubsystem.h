@@ -0,0 +1,73 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ChaosDamageSubsystem.generated.h"
+
+class AController;
+class UDamageType;
+
+/** A single damage request waiting to be resolved at the end of the frame. */
+struct FChaosPendingDamage
+{
+	TObjectKey<AActor> Target;
+	TObjectKey<AActor> Causer;
+	TObjectKey<AController> Instigator;
+	TSubclassOf<UDamageType> DamageTypeClass;
+	float Amount = 0.f;
+};
+
+/**
+ * Collects all damage dealt during a frame and resolves it in a single pass once all actors have ticked.
+ * Everything a target received from one instigator with one damage type is summed into one TakeDamage call, so
+ * damage type reactions and kill credit stay with the hits they belong to. Every queued entry counts as a hit of
+ * its own; callers deduplicate repeated overlaps of one swing or shot before queueing. This keeps the
+ * TakeDamage -> ApplyHealthChange -> Die chain out of physics overlap callbacks and makes the cost linear in the
+ * number of damaged targets.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosDamageSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Queues damage on the target's world subsystem. Falls back to an immediate UGameplayStatics::ApplyDamage
+	 * if the world has no damage subsystem (e.g. editor preview worlds).
+	 * @param Target The actor that should receive the damage.
+	 * @param Amount The amount of damage to deal.
+	 * @param EventInstigator The controller responsible for the damage.
+	 * @param DamageCauser The actor that actually caused the damage (weapon, enemy, projectile).
+	 * @param DamageTypeClass The type of damage. Can be null.
+	 */
+	static void QueueDamage(AActor* Target, float Amount, AController* EventInstigator, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass);
+
+	/** Adds a damage request to this frame's queue. */
+	void EnqueueDamage(AActor* Target, float Amount, AController* EventInstigator, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass);
+
+	/** Resolves everything queued so far. Damage queued while resolving is deferred to the next pass. */
+	void ResolvePendingDamage();
+
+	/** Returns the number of damage requests waiting for the next resolve pass. */
+	int32 GetNumPendingDamage() const { return PendingDamage.Num(); }
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Damage queued during the current frame. */
+	TArray<FChaosPendingDamage> PendingDamage;
+
+	/** Damage currently being resolved. Kept as a member so both buffers keep their allocation between frames. */
+	TArray<FChaosPendingDamage> ResolvingDamage;
+};
@@ -0,0 +1,69 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ChaosMeleeQuerySubsystem.generated.h"
+
+class AChaosCharacterBase;
+class AController;
+class UDamageType;
+
+/**
+ * Runs melee hit sweeps as asynchronous scene queries.
+ * Attacks submitted during a frame are handed to the physics scene together and traced in parallel with the rest of
+ * the frame instead of stalling the game thread one by one. At the start of the next frame, before any actor ticks,
+ * the subsystem collects all results in a single pass and queues the damage on the UChaosDamageSubsystem, which
+ * resolves it in that same frame like any other hit.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosMeleeQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Submits a sphere sweep on ECC_Pawn. Every character it hits, except the attacker, receives the damage next frame.
+	 * @param Attacker The attacking character. Also the damage causer.
+	 * @param Start Where the sweep starts.
+	 * @param End Where the sweep ends.
+	 * @param Radius The radius of the swept sphere.
+	 * @param Damage The damage each hit character receives.
+	 * @param DamageTypeClass The type of damage. Can be null.
+	 */
+	void SubmitMeleeSweep(AChaosCharacterBase* Attacker, const FVector& Start, const FVector& End, float Radius, float Damage, TSubclassOf<UDamageType> DamageTypeClass);
+
+	/** Returns the number of sweeps waiting for their results. */
+	int32 GetNumPendingSweeps() const { return PendingSweeps.Num(); }
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Bound to FWorldDelegates::OnWorldPreActorTick. Applies the results of last frame's sweeps. */
+	void HandleWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** A submitted sweep and the damage it deals. */
+	struct FPendingSweep
+	{
+		FTraceHandle Handle;
+		TWeakObjectPtr<AChaosCharacterBase> Attacker;
+		TWeakObjectPtr<AController> Instigator;
+		TSubclassOf<UDamageType> DamageTypeClass;
+		float Damage = 0.f;
+	};
+
+	/** Sweeps in flight. */
+	TArray<FPendingSweep> PendingSweeps;
+
+	FDelegateHandle PreActorTickHandle;
+};
@@ -0,0 +1,149 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/ObjectKey.h"
+#include "ChaosProjectileSubsystem.generated.h"
+
+class AController;
+class UDamageType;
+
+/** Describes a kind of projectile fired through the UChaosProjectileSubsystem. */
+USTRUCT(BlueprintType)
+struct FChaosProjectileSpec
+{
+	GENERATED_BODY()
+
+	/** The speed the projectile is fired with, in cm/s. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+	float Speed = 3000.f;
+
+	/** How strongly world gravity pulls on the projectile. 0 flies in a straight line. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float GravityScale = 0.f;
+
+	/** The radius of the sphere swept along the projectile's path. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+	float Radius = 10.f;
+
+	/** Seconds until the projectile disappears without hitting anything. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+	float Lifetime = 3.f;
+
+	/** The damage dealt to the actor the projectile hits. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float Damage = 20.f;
+
+	/** The type of damage dealt. Can be null. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	TSubclassOf<UDamageType> DamageTypeClass;
+
+	/**
+	 * The actor shown at the projectile's location, e.g. a mesh or particle effect. Taken from a pool and moved by
+	 * the subsystem; its collision and movement components are disabled. Can be null for invisible projectiles.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	TSubclassOf<AActor> VisualClass;
+};
+
+/**
+ * Simulates projectiles as plain data records instead of actors.
+ * Every projectile is a row in parallel arrays (location, velocity, lifetime, damage, owner) that are advanced in
+ * one pass per frame, before any actor ticks. The path each projectile covers in a frame is swept as an asynchronous
+ * scene query, and the results are collected in a single pass at the start of the next frame: projectiles that hit
+ * something queue their damage on the UChaosDamageSubsystem and are removed, all others move on to the end of
+ * their sweep. Projectiles therefore never pass through a surface, but are shown one frame behind the simulation.
+ * What players see are pooled visual actors that follow the records and are returned to their pool when the
+ * projectile dies.
+ * The budgets can be tuned in the [/Script/ChaosRifts.ChaosProjectileSubsystem] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosProjectileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Fires a projectile.
+	 * @param Spec What kind of projectile to fire.
+	 * @param Location Where the projectile starts.
+	 * @param Direction The direction it is fired in. Does not need to be normalized.
+	 * @param Owner The actor firing it. Never hit by its own projectiles and the damage causer of their hits.
+	 * @return False if the projectile budget is exhausted.
+	 */
+	bool FireProjectile(const FChaosProjectileSpec& Spec, const FVector& Location, const FVector& Direction, AActor* Owner);
+
+	/** Returns the number of projectiles in flight. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Combat")
+	int32 GetNumProjectiles() const { return Locations.Num(); }
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/** The most projectiles in flight at once. Projectiles fired beyond this are dropped. */
+	UPROPERTY(Config)
+	int32 MaxProjectiles = 2048;
+
+	/** The most hidden visual actors kept per visual class. Visuals returned to a full pool are destroyed. */
+	UPROPERTY(Config)
+	int32 MaxPooledVisualsPerClass = 64;
+
+private:
+	/** Bound to FWorldDelegates::OnWorldPreActorTick. Advances all projectiles by one frame. */
+	void HandleWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Collects last frame's sweeps. Projectiles that hit something deal their damage and are removed. */
+	void ResolveSweeps();
+
+	/** Integrates all projectiles, removes the expired ones and submits the sweeps of this frame's movement. */
+	void SimulateProjectiles(float DeltaTime);
+
+	/** Moves the visual actors to their projectiles. */
+	void UpdateVisuals();
+
+	/** Removes a projectile. The last projectile is moved into the freed slot. */
+	void RemoveProjectile(int32 ProjectileIndex);
+
+	/** Takes a visual actor of a class from its pool, or spawns one. */
+	AActor* AcquireVisual(TSubclassOf<AActor> VisualClass, const FVector& Location, const FRotator& Rotation);
+
+	/** Hides a visual actor and returns it to its pool. */
+	void ReleaseVisual(AActor* Visual);
+
+	//~ The record columns. Index N of every array belongs to the same projectile.
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> GravityScales;
+	TArray<float> Radii;
+	TArray<float> RemainingLifetimes;
+	TArray<float> Damages;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+	TArray<TWeakObjectPtr<AController>> Instigators;
+	TArray<TWeakObjectPtr<AActor>> Visuals;
+
+	/** Where each projectile's sweep of last frame ends. The projectile moves there if the sweep hits nothing. */
+	TArray<FVector> SweepEnds;
+
+	/** Each projectile's sweep in flight. Invalid for projectiles fired since the last simulation pass. */
+	TArray<FTraceHandle> SweepHandles;
+
+	/** The type of damage each projectile deals. */
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<UDamageType>> DamageTypeClasses;
+
+	/** Hidden visual actors, per visual class. */
+	TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<AActor>>> VisualPools;
+
+	FDelegateHandle PreActorTickHandle;
+};
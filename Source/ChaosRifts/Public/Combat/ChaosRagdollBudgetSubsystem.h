@@ -0,0 +1,84 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ChaosRagdollBudgetSubsystem.generated.h"
+
+class AChaosCharacterBase;
+
+/**
+ * Caps how many dead characters simulate ragdoll physics at the same time.
+ * Dying characters request a ragdoll here instead of enabling physics themselves. While the budget has room they
+ * simulate; once it is full, a new corpse takes the slot of the farthest ragdoll that is already at rest, if that one
+ * is farther from the camera than the new corpse. Ragdolls that are still falling are never evicted. Ragdolls that
+ * have settled or simulated for too long are frozen as well. A frozen corpse keeps its last pose with physics,
+ * animation and skeleton updates off, so it costs neither the physics nor the game thread anything. A corpse that
+ * never got to ragdoll is first put into the character's death pose, so it does not stay frozen upright.
+ * The budget can be tuned in the [/Script/ChaosRifts.ChaosRagdollBudgetSubsystem] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosRagdollBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Ragdolls a dead character if the budget allows it, otherwise freezes it in its death pose. */
+	void RequestRagdoll(AChaosCharacterBase* Character);
+
+	/** Stops tracking a character, e.g. when it is reused from a pool. Does not change its mesh. */
+	void CancelRagdoll(AChaosCharacterBase* Character);
+
+	/** Returns the number of ragdolls currently simulating. */
+	int32 GetNumSimulatedRagdolls() const { return SimulatedRagdolls.Num(); }
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/** The maximum number of ragdolls simulating at the same time. */
+	UPROPERTY(Config)
+	int32 MaxSimulatedRagdolls = 12;
+
+	/** A ragdoll whose root moves slower than this (cm/s) is considered at rest. */
+	UPROPERTY(Config)
+	float SettledSpeed = 15.f;
+
+	/** How long a ragdoll has to be at rest before it is frozen. */
+	UPROPERTY(Config)
+	float SettledTime = 0.5f;
+
+	/** Ragdolls are frozen after simulating this long, even if they never came to rest. */
+	UPROPERTY(Config)
+	float MaxSimulationTime = 6.f;
+
+private:
+	struct FSimulatedRagdoll
+	{
+		TWeakObjectPtr<AChaosCharacterBase> Character;
+		float SimulatedTime = 0.f;
+		float TimeAtRest = 0.f;
+	};
+
+	/** Enables ragdoll physics on a character's mesh. */
+	static void StartRagdoll(AChaosCharacterBase* Character);
+
+	/** Turns physics off and keeps the current pose. */
+	static void FreezePose(AChaosCharacterBase* Character);
+
+	/** Puts a corpse that never ragdolled into a lying pose, then freezes it. */
+	static void FreezeInDeathPose(AChaosCharacterBase* Character);
+
+	/** Returns the location budget priorities are measured from. */
+	FVector GetViewLocation() const;
+
+	/** The ragdolls currently simulating. Never more than MaxSimulatedRagdolls. */
+	TArray<FSimulatedRagdoll> SimulatedRagdolls;
+};
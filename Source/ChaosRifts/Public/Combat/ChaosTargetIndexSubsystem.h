@@ -0,0 +1,83 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Characters/Base/ChaosCharacterBase.h"
+#include "ChaosTargetIndexSubsystem.generated.h"
+
+/**
+ * A uniform 2D grid (spatial hash) of all living characters in the world.
+ * Characters register themselves at BeginPlay and unregister when they die or leave play. The grid cells are
+ * updated incrementally once per frame, after all actors have moved, so only characters that crossed a cell
+ * boundary are touched. Combat code can query it for candidate targets instead of running a physics scene query.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosTargetIndexSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Adds a living character to the index. Registering a character twice has no effect. */
+	void RegisterCharacter(AChaosCharacterBase* Character);
+
+	/** Removes a character from the index, e.g. when it dies. */
+	void UnregisterCharacter(AChaosCharacterBase* Character);
+
+	/**
+	 * Collects all indexed characters within a horizontal radius of a point. The test is done against the
+	 * character capsules in 2D, so the result is a conservative candidate list for a narrow-phase check.
+	 * @param Center The center of the query.
+	 * @param Radius The horizontal query radius.
+	 * @param IgnoredTeam Characters of this team are skipped. Pass EChaosTeam::Neutral to only skip neutrals.
+	 * @param OutCharacters Receives the candidates. The array is reset first.
+	 */
+	void QueryCharacters(const FVector& Center, float Radius, EChaosTeam IgnoredTeam, TArray<AChaosCharacterBase*>& OutCharacters) const;
+
+	/** Returns the number of characters currently in the index. */
+	int32 GetNumCharacters() const { return Entries.Num(); }
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AChaosCharacterBase> Character;
+		TObjectKey<AChaosCharacterBase> Key;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.f;
+		EChaosTeam Team = EChaosTeam::Neutral;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		int32 IndexInCell = INDEX_NONE;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+	void AddToCell(int32 EntryIndex);
+	void RemoveFromCell(int32 EntryIndex);
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Edge length of a grid cell. Roughly the size of the largest attack reach in the game. */
+	float CellSize = 400.f;
+
+	/** The largest capsule radius ever registered, used to widen the range of cells a query visits. */
+	float MaxEntryRadius = 0.f;
+
+	/** Densely packed index entries. */
+	TArray<FEntry> Entries;
+
+	/** Maps a registered character to its slot in Entries. */
+	TMap<TObjectKey<AChaosCharacterBase>, int32> EntryIndices;
+
+	/** The entry indices of every occupied grid cell. */
+	TMap<FIntPoint, TArray<int32>> Cells;
+};
@@ -4,12 +4,40 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Core/ChaosAttributeSubsystem.h"
 #include "ChaosAttributes.generated.h"
 
+/** The attributes reported through OnAttributeChanged. */
+UENUM(BlueprintType)
+enum class EChaosAttribute : uint8
+{
+	Health,
+	Chaos,
+	HealCharges,
+
+	Num UMETA(Hidden)
+};
+
+// Broadcast at most once per attribute and frame, with the value before the first and after the last change.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnAttributeChangedDelegate, UChaosAttributes*, Attributes, EChaosAttribute, Attribute, float, OldValue, float, NewValue);
+
+// Broadcast when Health drops to zero.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHealthDepletedDelegate, UChaosAttributes*, Attributes);
+
+// Broadcast when regeneration fills Chaos up to MaxChaos (e.g. to enable Ultimate Abilities).
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChaosFullDelegate, UChaosAttributes*, Attributes);
+
+// Broadcast when a heal charge finished recharging.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHealChargeGainedDelegate, UChaosAttributes*, Attributes, int32, NewHealCharges);
+
 /**
  * Manages all gameplay-relevant attributes for a character, such as Health and Chaos.
  * This component can be attached to any actor to give it attributes.
  * It is designed to be the single source of truth for all vitals and resources.
+ * During play the values live in the world's UChaosAttributeSubsystem, which keeps the attributes of all
+ * characters in contiguous arrays; the component only holds a handle into it.
+ * Chaos and heal charges change continuously over time. Instead of ticking, they are stored as (value, rate,
+ * timestamp) and evaluated on read; a timer is only scheduled for the moment a threshold is crossed.
  */
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class CHAOSRIFTS_API UChaosAttributes : public UActorComponent
@@ -19,27 +47,48 @@ class CHAOSRIFTS_API UChaosAttributes : public UActorComponent
 public:	
 	UChaosAttributes();
 
+	/**
+	 * Broadcast at the end of a frame for every attribute that changed during it, so any number of changes in one
+	 * frame cost a single notification. UI and AI should bind to this instead of polling the getters.
+	 * Continuous Chaos regeneration is not reported frame by frame; it is reported when it is interrupted by a
+	 * direct change and via OnChaosFull. Heal charges are reported whenever one finished recharging.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Chaos|Attributes")
+	FOnAttributeChangedDelegate OnAttributeChanged;
+
+	/** Broadcast once when Health reaches zero. */
+	UPROPERTY(BlueprintAssignable, Category = "Chaos|Attributes")
+	FOnHealthDepletedDelegate OnHealthDepleted;
+
+	/** Broadcast when regeneration filled Chaos up. Not broadcast for direct changes through ApplyChaosChange. */
+	UPROPERTY(BlueprintAssignable, Category = "Chaos|Attributes")
+	FOnChaosFullDelegate OnChaosFull;
+
+	/** Broadcast when a heal charge finished recharging over time. */
+	UPROPERTY(BlueprintAssignable, Category = "Chaos|Attributes")
+	FOnHealChargeGainedDelegate OnHealChargeGained;
+
 	//~==============================================================================================
 	//~ Getters - Functions to safely read attribute values from anywhere.
 	//~==============================================================================================
 
-	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	float GetHealth() const { return Health; }
+	UFUNCTION(BlueprintPure, Category = "Chaos|Attributes")
+	float GetHealth() const { return AttributeStore ? AttributeStore->GetHealth(StoreHandle) : Health; }
 	
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	float GetMaxHealth() const { return MaxHealth; }
+	float GetMaxHealth() const { return AttributeStore ? AttributeStore->GetMaxHealth(StoreHandle) : MaxHealth; }
 
-	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	float GetChaos() const { return Chaos; }
+	UFUNCTION(BlueprintPure, Category = "Chaos|Attributes")
+	float GetChaos() const;
 
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	float GetMaxChaos() const { return MaxChaos; }
+	float GetMaxChaos() const { return AttributeStore ? AttributeStore->GetMaxChaos(StoreHandle) : MaxChaos; }
 	
-	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	int32 GetHealCharges() const { return HealCharges; }
+	UFUNCTION(BlueprintPure, Category = "Chaos|Attributes")
+	int32 GetHealCharges() const;
 
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
-	int32 GetMaxHealCharges() const { return MaxHealCharges; }
+	int32 GetMaxHealCharges() const { return AttributeStore ? AttributeStore->GetMaxHealCharges(StoreHandle) : MaxHealCharges; }
 
 	//~==============================================================================================
 	//~ Attribute Modifiers - Public functions to change attribute values.
@@ -69,35 +118,167 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
 	void ApplyHealChargeChange(int32 Delta);
 
+	/**
+	 * Sets a continuous health change per second, e.g. negative for poison or positive for regeneration.
+	 * Applied for all characters at once by the attribute store. Pass 0 to stop it.
+	 * @param HealthPerSecond The amount of health gained (or lost) per second.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetHealthRate(float HealthPerSecond);
+
+	/**
+	 * Sets a continuous chaos change per second, e.g. for regeneration or decay. Pass 0 to stop it.
+	 * The value is evaluated lazily, so this has no per-frame cost.
+	 * @param ChaosPerSecond The amount of chaos gained (or lost) per second.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetChaosRate(float ChaosPerSecond);
+
+	/**
+	 * Sets how long it takes to recharge one heal charge. Pass 0 to disable recharging over time.
+	 * @param SecondsPerCharge The recharge time of a single charge.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetHealChargeRechargeTime(float SecondsPerCharge);
+
+	//~==============================================================================================
+	//~ Maximum Values - Changing them at runtime must go through these setters to keep the store in sync.
+	//~==============================================================================================
+
+	/** Sets MaxHealth and clamps the current Health to it. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetMaxHealth(float NewMaxHealth);
+
+	/** Sets MaxChaos and clamps the current Chaos to it. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetMaxChaos(float NewMaxChaos);
+
+	/** Sets MaxHealCharges and clamps the current HealCharges to it. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void SetMaxHealCharges(int32 NewMaxHealCharges);
+
+	/**
+	 * Restores all maximums and rates to their defaults and fills every attribute up, as if the owner was freshly
+	 * spawned. Used when a pooled character is reused.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Attributes")
+	void ResetAttributes();
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	//~==============================================================================================
 	//~ Attributes - The actual data properties. EditDefaultsOnly allows setting base values in Blueprints.
 	//~==============================================================================================
 
-	/** The current health of the character. Is initialized to MaxHealth in BeginPlay. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Chaos|Attributes")
+	/**
+	 * The health of the character. Is initialized to MaxHealth in BeginPlay. While the component is registered with
+	 * the attribute store the current value lives there; Blueprints reading this property go through GetHealth().
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintGetter = GetHealth, Category = "Chaos|Attributes")
 	float Health;
 
 	/** The maximum health of the character. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Chaos|Attributes", meta = (ClampMin = "1.0"))
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes", meta = (ClampMin = "1.0"))
 	float MaxHealth = 100.f;
 
-	/** The current chaos (mana/resource) of the character. Is initialized to MaxChaos in BeginPlay. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Chaos|Attributes")
+	/**
+	 * The chaos (mana/resource) of the character at ChaosTimestamp. Is initialized to MaxChaos in BeginPlay.
+	 * Read through GetChaos() in Blueprints, since the attribute store holds the current value, like Health's.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintGetter = GetChaos, Category = "Chaos|Attributes")
 	float Chaos;
 
 	/** The maximum chaos (mana/resource) of the character. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Chaos|Attributes")
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes")
 	float MaxChaos = 100.f;
 
-	/** The current number of heal charges (potions). Is initialized to MaxHealCharges in BeginPlay. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Chaos|Attributes")
+	/**
+	 * The number of heal charges (potions) at HealChargeTimestamp. Is initialized to MaxHealCharges in BeginPlay.
+	 * Read through GetHealCharges() in Blueprints, since the attribute store holds the current value, like Health's.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintGetter = GetHealCharges, Category = "Chaos|Attributes")
 	int32 HealCharges;
 
 	/** The maximum number of heal charges (potions). */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Chaos|Attributes", meta = (ClampMin = "0"))
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes", meta = (ClampMin = "0"))
 	int32 MaxHealCharges = 3;
+
+	/** The continuous health change per second. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes")
+	float HealthRate = 0.f;
+
+	/** The continuous chaos change per second, e.g. positive for regeneration or negative for decay. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes")
+	float ChaosRate = 0.f;
+
+	/** The time in seconds it takes to recharge one heal charge. 0 disables recharging over time. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|Attributes", meta = (ClampMin = "0.0"))
+	float HealChargeRechargeTime = 0.f;
+
+private:
+	friend class UChaosAttributeSubsystem;
+
+	/** Called by the attribute store when a bulk pass (e.g. poison) depleted Health. */
+	void HandleHealthDepleted();
+
+	/**
+	 * Flags an attribute as changed this frame. Only the first call per frame remembers OldValue, so the
+	 * notification spans all changes of the frame.
+	 */
+	void MarkAttributeDirty(EChaosAttribute Attribute, float OldValue);
+
+	/** Broadcasts OnAttributeChanged for all dirty attributes and clears them. */
+	void FlushAttributeChanges();
+
+	/** Returns the current value of an attribute as reported by OnAttributeChanged. */
+	float GetAttributeValue(EChaosAttribute Attribute) const;
+
+	/** Writes the lazily evaluated Chaos back as the new base value and restarts its evaluation from now. */
+	void MaterializeChaos();
+
+	/** Writes the lazily evaluated heal charges back, keeping the progress of a partially recharged charge. */
+	void MaterializeHealCharges();
+
+	/** Schedules (or clears) the single timer for the moment regeneration fills Chaos up. */
+	void ScheduleChaosThreshold();
+
+	/** Schedules (or clears) the single timer for the moment the next heal charge finishes recharging. */
+	void ScheduleHealChargeThreshold();
+
+	void HandleChaosFull();
+	void HandleHealChargeRecharged();
+
+	/** Returns the world time the timestamps are relative to. */
+	double GetTimeSeconds() const;
+
+	/** The writable stored values, either in the attribute store or in this component. */
+	float& HealthValue() { return AttributeStore ? AttributeStore->Health[StoreHandle] : Health; }
+	float& ChaosValue() { return AttributeStore ? AttributeStore->Chaos[StoreHandle] : Chaos; }
+	double& ChaosTimestampValue() { return AttributeStore ? AttributeStore->ChaosTimestamp[StoreHandle] : ChaosTimestamp; }
+	int32& HealChargesValue() { return AttributeStore ? AttributeStore->HealCharges[StoreHandle] : HealCharges; }
+	double& HealChargeTimestampValue() { return AttributeStore ? AttributeStore->HealChargeTimestamp[StoreHandle] : HealChargeTimestamp; }
+
+	/** The world time at which Chaos had its stored value. */
+	double ChaosTimestamp = 0.0;
+
+	/** The world time at which the recharge of the next heal charge started. */
+	double HealChargeTimestamp = 0.0;
+
+	FTimerHandle TimerHandle_ChaosFull;
+	FTimerHandle TimerHandle_HealCharge;
+
+	/** One bit per EChaosAttribute that changed since the last flush. */
+	uint8 DirtyAttributeMask = 0;
+
+	/** The value of each dirty attribute at the time it was first changed this frame. */
+	float DirtyOldValues[static_cast<int32>(EChaosAttribute::Num)] = {};
+
+	/** The store holding this component's values during play. Null if the world has no store. */
+	UPROPERTY(Transient)
+	TObjectPtr<UChaosAttributeSubsystem> AttributeStore;
+
+	/** This component's slot in the attribute store. */
+	int32 StoreHandle = INDEX_NONE;
 };
@@ -0,0 +1,163 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ChaosAttributeSubsystem.generated.h"
+
+class UChaosAttributes;
+
+/**
+ * Structure-of-arrays backing store for all UChaosAttributes components in a world.
+ * Every registered component owns one slot (its handle) in a set of tightly packed parallel arrays. The components'
+ * getters and Apply* functions read and write these arrays, so global passes such as damage-over-time, regeneration
+ * or rune modifiers run as a single loop over contiguous memory instead of walking actors and components.
+ * Components in worlds without this subsystem (e.g. editor previews) keep their values themselves.
+ * The store also collects the components whose attributes changed during a frame and flushes their
+ * OnAttributeChanged notifications once, after all actors and tickables have ticked.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosAttributeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	friend class UChaosAttributes;
+
+public:
+	//~==============================================================================================
+	//~ Per-Entity Access
+	//~==============================================================================================
+
+	FORCEINLINE float GetHealth(int32 Handle) const { return Health[Handle]; }
+	FORCEINLINE float GetMaxHealth(int32 Handle) const { return MaxHealth[Handle]; }
+	FORCEINLINE float GetMaxChaos(int32 Handle) const { return MaxChaos[Handle]; }
+	FORCEINLINE int32 GetMaxHealCharges(int32 Handle) const { return MaxHealCharges[Handle]; }
+
+	/** Chaos is evaluated lazily from its last written value, its rate and the time since it was written. */
+	float GetChaos(int32 Handle) const;
+
+	/** Heal charges are evaluated lazily from the last written count and the time spent recharging since. */
+	int32 GetHealCharges(int32 Handle) const;
+
+	//~==============================================================================================
+	//~ Lazy Evaluation - Shared by the store and by components that run without one.
+	//~==============================================================================================
+
+	/** Evaluates a value changing linearly since a timestamp, clamped between 0 and MaxValue. */
+	static float EvaluateLinear(float BaseValue, float RatePerSecond, double Timestamp, double Now, float MaxValue)
+	{
+		return FMath::Clamp(BaseValue + RatePerSecond * static_cast<float>(Now - Timestamp), 0.f, MaxValue);
+	}
+
+	/** Evaluates a count that gains one charge per Interval since a timestamp, capped at MaxCharges. */
+	static int32 EvaluateCharges(int32 BaseCharges, float Interval, double Timestamp, double Now, int32 MaxCharges)
+	{
+		if (Interval <= 0.f || BaseCharges >= MaxCharges)
+		{
+			return BaseCharges;
+		}
+		// The small bias makes a timer firing exactly on the threshold count the charge despite rounding.
+		const int32 Gained = FMath::FloorToInt32(static_cast<float>((Now - Timestamp) / Interval) + 1.e-4f);
+		return FMath::Min(MaxCharges, BaseCharges + FMath::Max(Gained, 0));
+	}
+
+	/** Returns the number of components backed by this store. */
+	int32 GetNumEntities() const { return Owners.Num(); }
+
+	//~==============================================================================================
+	//~ Global Passes
+	//~==============================================================================================
+
+	/** Changes the health of every entity by the same delta, e.g. for a rune modifier or a global AoE. */
+	void ApplyHealthChangeToAll(float Delta);
+
+	/** Changes the chaos of every entity by the same delta. */
+	void ApplyChaosChangeToAll(float Delta);
+
+	/** Returns the world time all timestamps in the store are relative to. */
+	double GetTimeSeconds() const;
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Adds a component to the store, initialized from the component's current values. Returns its handle. */
+	int32 Register(UChaosAttributes* Attributes);
+
+	/** Removes a component from the store. The last slot is moved into the freed one to keep the arrays dense. */
+	void Unregister(int32 Handle);
+
+	/** Sets the per-second health rate of an entity. Keeps track of how many entities have a rate. */
+	void SetHealthRate(int32 Handle, float Rate);
+
+	/** Sets the per-second chaos rate of an entity. Chaos is not ticked; the rate only affects evaluation. */
+	void SetChaosRate(int32 Handle, float Rate);
+
+	/** Adds the per-entity deltas in FrameDeltas to all health values and notifies those whose health ran out. */
+	void ApplyFrameDeltasToHealth();
+
+	/** Remembers a component to flush its attribute change notifications at the end of the frame. */
+	void QueueAttributeFlush(UChaosAttributes* Attributes);
+
+	/** Flushes the attribute change notifications of all components that changed this frame. */
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	//~ The attribute columns. Index N of every array belongs to the same component.
+	TArray<float> Health;
+	TArray<float> MaxHealth;
+	TArray<float> MaxChaos;
+	TArray<int32> MaxHealCharges;
+
+	/** Continuous health change per second, e.g. negative for poison. Applied by the per-frame pass. */
+	TArray<float> HealthRate;
+
+	/** Chaos as (value, rate, timestamp). The current value is computed on read, so regeneration costs nothing per frame. */
+	TArray<float> Chaos;
+	TArray<float> ChaosRate;
+	TArray<double> ChaosTimestamp;
+
+	/** Heal charges as (count, recharge interval, timestamp the current recharge started). Computed on read. */
+	TArray<int32> HealCharges;
+	TArray<float> HealChargeInterval;
+	TArray<double> HealChargeTimestamp;
+
+	/**
+	 * The component owning each slot. Components unregister themselves in EndPlay; the pointers are weak so a
+	 * component that is destroyed without it is skipped by the passes instead of being dereferenced.
+	 */
+	TArray<TWeakObjectPtr<UChaosAttributes>> Owners;
+
+	/** Scratch buffer flagging entities whose health was depleted by a bulk pass. */
+	TArray<uint8> DepletedFlags;
+
+	/** Scratch buffer for the per-entity deltas of a bulk pass. */
+	TArray<float> FrameDeltas;
+
+	/** Scratch buffer for the values before a bulk pass, used to report the changes. */
+	TArray<float> PreviousValues;
+
+	/** Components with attribute changes to report at the end of this frame. Each is queued once per frame. */
+	TArray<TWeakObjectPtr<UChaosAttributes>> DirtyAttributes;
+
+	FDelegateHandle PostActorTickHandle;
+
+	/** How many entities have a non-zero health rate. The rate pass is skipped entirely when this is zero. */
+	int32 NumHealthRates = 0;
+
+	/** How many entities have a non-zero chaos rate. Only those need their thresholds rescheduled after bulk changes. */
+	int32 NumChaosRates = 0;
+};
@@ -0,0 +1,73 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** The kinds of events recorded in the combat trace. Values are stored in dumps, only append new ones. */
+enum class EChaosCombatEvent : uint8
+{
+	HealthChanged,
+	ChaosChanged,
+	HealChargesChanged,
+	WeaponHitDetectionEnabled,
+	WeaponHitDetectionDisabled,
+	MeleeHit,
+	ProjectileHit,
+	PelletHit,
+
+	Num
+};
+
+/**
+ * A single binary combat trace record. Actors are stored by their UObject unique ID, so recording never
+ * touches names or strings. The meaning of the values depends on the event type (see LexToString).
+ */
+struct FChaosCombatTraceRecord
+{
+	/** The engine frame the event happened in. */
+	uint64 Frame = 0;
+
+	/** The slot sequence this record was written for plus one. 0 means the record was never written. */
+	std::atomic<uint64> Sequence = 0;
+
+	uint32 SourceId = 0;
+	uint32 TargetId = 0;
+	float Values[3] = {};
+	EChaosCombatEvent Type = EChaosCombatEvent::Num;
+};
+
+/**
+ * Fixed-size, lock-free ring buffer of compact combat events, replacing per-hit log formatting.
+ * Recording is a handful of stores into preallocated memory and is safe from any thread; once the buffer is
+ * full the oldest records are overwritten. The buffer can be dumped to disk on demand (Chaos.CombatTrace.Dump),
+ * is dumped automatically on a crash into Saved/CombatTrace/CombatTrace-Crash-<ProcessId>.bin (a file opened when
+ * the first game or PIE world starts and written without allocating; commandlets and dedicated servers get none),
+ * and can be decoded into readable log lines with Chaos.CombatTrace.Decode.
+ */
+class CHAOSRIFTS_API FChaosCombatTrace
+{
+public:
+	/** The number of records kept. Must be a power of two. */
+	static constexpr uint32 Capacity = 16 * 1024;
+
+	/** Records an event. Does nothing while tracing is disabled through Chaos.CombatTrace.Enabled. */
+	static void Record(EChaosCombatEvent Type, const UObject* Source, const UObject* Target, float Value0 = 0.f, float Value1 = 0.f, float Value2 = 0.f);
+
+	/**
+	 * Writes the records currently in the buffer to a binary file, oldest first.
+	 * @param Filename The file to write. Empty writes a timestamped file into Saved/CombatTrace.
+	 * @return The written file, or an empty string on failure.
+	 */
+	static FString DumpToFile(const FString& Filename = FString());
+
+	/** Decodes a file written by DumpToFile into readable log lines. */
+	static bool DecodeFile(const FString& Filename);
+
+	/** Decodes the records currently in the buffer into readable log lines. */
+	static void DecodeLive();
+};
+
+/** Returns the name of an event type and the meaning of its values. */
+CHAOSRIFTS_API const TCHAR* LexToString(EChaosCombatEvent Type);
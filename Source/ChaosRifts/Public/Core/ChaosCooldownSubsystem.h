@@ -0,0 +1,128 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ChaosCooldownSubsystem.generated.h"
+
+/**
+ * Gameplay cooldowns for every actor in a world, keyed by owner and cooldown name.
+ * Cooldowns live in a hierarchical timing wheel: three levels of 64 slots each, the first one TickResolution seconds
+ * per slot, each following level 64 times coarser. Starting, restarting and cancelling a cooldown is O(1) and never
+ * touches a heap; once per frame the slots that came due are expired in bulk, and entries in the coarser levels are
+ * moved down as their time draws near. Characters ask IsCooldownReady instead of keeping bCanX flags and timers.
+ * The resolution can be tuned in the [/Script/ChaosRifts.ChaosCooldownSubsystem] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class CHAOSRIFTS_API UChaosCooldownSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Starts a cooldown, or restarts it if it is already running.
+	 * @param Owner The object the cooldown belongs to.
+	 * @param CooldownId Which of the owner's cooldowns to start.
+	 * @param Duration How long the cooldown runs, in seconds.
+	 * @param OnExpired Optionally executed once the cooldown has run out. Replaces the callback of a restarted cooldown.
+	 */
+	void StartCooldown(const UObject* Owner, FName CooldownId, float Duration, FSimpleDelegate OnExpired = FSimpleDelegate());
+
+	/** Stops a running cooldown without executing its callback. */
+	void CancelCooldown(const UObject* Owner, FName CooldownId);
+
+	/** Stops all of an owner's cooldowns without executing their callbacks. */
+	void CancelAllCooldowns(const UObject* Owner);
+
+	/** Returns whether a cooldown is not running (anymore). */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Cooldowns")
+	bool IsCooldownReady(const UObject* Owner, FName CooldownId) const;
+
+	/** Returns the seconds left on a cooldown, or 0 if it is ready. */
+	UFUNCTION(BlueprintCallable, Category = "Chaos|Cooldowns")
+	float GetRemainingCooldown(const UObject* Owner, FName CooldownId) const;
+
+	/** Returns the number of cooldowns in the wheel. */
+	int32 GetNumActiveCooldowns() const { return ActiveCooldowns.Num(); }
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+protected:
+	/** The length of one slot in the finest level of the wheel, in seconds. Callbacks fire at most this late. */
+	UPROPERTY(Config)
+	float TickResolution = 1.f / 60.f;
+
+private:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+	static constexpr int32 NumLevels = 3;
+
+	/** A list outside the wheel holding the entries of the slot being processed, so callbacks can cancel them safely. */
+	static constexpr int32 PendingSlot = NumLevels * NumSlots;
+
+	/** The farthest ahead an entry can be placed. Longer cooldowns are placed here and re-placed when they come due. */
+	static constexpr int64 MaxTickDelta = (int64(1) << (SlotBits * NumLevels)) - 1;
+
+	struct FCooldownKey
+	{
+		TObjectKey<UObject> Owner;
+		FName CooldownId;
+
+		bool operator==(const FCooldownKey& Other) const { return Owner == Other.Owner && CooldownId == Other.CooldownId; }
+		friend uint32 GetTypeHash(const FCooldownKey& Key) { return HashCombineFast(GetTypeHash(Key.Owner), GetTypeHash(Key.CooldownId)); }
+	};
+
+	/** A running cooldown. Entries in the same slot form an intrusive doubly linked list. */
+	struct FEntry
+	{
+		FCooldownKey Key;
+		FSimpleDelegate OnExpired;
+		double ExpireTime = 0.0;
+		int64 ExpireTick = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 Slot = INDEX_NONE;
+	};
+
+	/** Puts an entry into the slot matching the distance between its expiry and NextTick. */
+	void LinkEntry(int32 EntryIndex);
+
+	/** Takes an entry out of its slot. */
+	void UnlinkEntry(int32 EntryIndex);
+
+	/** Unlinks an entry, forgets its key and recycles it. */
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Moves all entries of a slot to the pending list. */
+	void MoveSlotToPending(int32 Slot);
+
+	/** Processes one tick of the wheel: moves due entries down from the coarser levels and expires the finest slot. */
+	void AdvanceTick();
+
+	/** Converts a world time to wheel ticks, rounding up so callbacks never fire early. */
+	int64 TimeToTick(double Time) const;
+
+	/** All entries, live or free. Slots and lists refer to them by index. */
+	TArray<FEntry> Entries;
+
+	/** The indices of recycled entries. */
+	TArray<int32> FreeEntries;
+
+	/** The first entry of each slot, level by level, followed by the pending list. */
+	int32 SlotHeads[PendingSlot + 1];
+
+	/** Finds the entry of a running cooldown. */
+	TMap<FCooldownKey, int32> ActiveCooldowns;
+
+	/** The next tick the wheel processes. All earlier ticks are done. */
+	int64 NextTick = 0;
+};
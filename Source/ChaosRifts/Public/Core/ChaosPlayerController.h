@@ -7,6 +7,7 @@
 #include "ChaosPlayerController.generated.h"
 
 class UInputMappingContext;
+class UChaosHealthBarWidget;
 
 /**
  * Basic PlayerController class for a third person game
@@ -26,4 +27,23 @@ protected:
 	/** Input mapping context setup */
 	virtual void SetupInputComponent() override;
 
+	/** Sets up the pooled enemy health bars */
+	virtual void BeginPlay() override;
+
+	/** The widget used for enemy health bars. No health bars are drawn if this is not set. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|UI")
+	TSubclassOf<UChaosHealthBarWidget> HealthBarWidgetClass;
+
+	/** The maximum number of enemy health bars shown at once. The closest hurt enemies get one. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|UI", meta = (ClampMin = "0"))
+	int32 MaxHealthBars = 8;
+
+	/** Enemies farther away from the camera than this get no health bar. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|UI", meta = (ClampMin = "0.0"))
+	float HealthBarMaxDistance = 3000.f;
+
+	/** Offset from an enemy's location to where its health bar is drawn. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Chaos|UI")
+	FVector HealthBarWorldOffset = FVector(0.f, 0.f, 100.f);
+
 };
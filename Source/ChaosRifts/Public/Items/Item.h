@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
 #include "Item.generated.h"
 
 class UCapsuleComponent;
@@ -12,6 +13,15 @@ class UStaticMeshComponent; // Forward declaration for the new mesh component
 // Delegate that is triggered when the overlap status of an item changes.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemOverlapSignature, AActor*, OverlappedActor, bool, bIsOverlapping);
 
+// Bookkeeping for an actor in AItem::OverlappingActors.
+struct FItemOverlapEntry
+{
+	// The number of hit capsule overlaps currently holding this actor.
+	int32 RefCount = 0;
+	// The index of the actor in the OverlappingActors array.
+	int32 ArrayIndex = INDEX_NONE;
+};
+
 /**
  * AItem is the base class for all pickup-able or interactive objects in the world.
  * It implements a generic collision detection mechanic with multiple hit capsules.
@@ -47,21 +57,43 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Item|Collision")
 	const TArray<AActor*>& GetItemOverlappingActors() const { return OverlappingActors; }
 
+	/**
+	 * Recompiles the lookup tables built from the ignore settings (e.g. IgnoredActors).
+	 * Call this after changing the ignore settings at runtime.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Item|Collision")
+	virtual void RebuildIgnoreFilters();
+
+	/** Replaces the actor instances this item ignores and recompiles their lookup. */
+	UFUNCTION(BlueprintCallable, Category = "Item|Collision")
+	void SetIgnoredActors(const TArray<AActor*>& NewIgnoredActors);
+
 protected:
 	virtual void BeginPlay() override;
 
+	/** Returns true if overlaps with this actor should be ignored (the item itself, the owner or an ignored instance). */
+	bool IsIgnoredActor(const AActor* OtherActor) const;
+
 	// If true, the item will not generate overlap events with its owner.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item|Collision")
 	bool bIgnoreOwner = true;
 
 	// A list of specific actor instances to ignore during overlap checks.
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item|Collision", meta = (DisplayName = "Ignored Actor Instances"))
+	// Compiled at BeginPlay; set it at runtime through SetIgnoredActors().
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item|Collision", meta = (DisplayName = "Ignored Actor Instances"))
 	TArray<TObjectPtr<AActor>> IgnoredActors;
 
 	// Array for storing all actors that are currently overlapping with one of the hit capsules.
+	// The order is not stable; actors leaving the item are swapped with the last element.
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Item|State")
 	TArray<TObjectPtr<AActor>> OverlappingActors;
 
+	// Reference counts of the overlapping actors, so an actor only leaves the item once it left every capsule.
+	TMap<TObjectKey<AActor>, FItemOverlapEntry> OverlapEntries;
+
+	// IgnoredActors compiled into a set at BeginPlay, so ignore checks in overlap callbacks are constant time.
+	TSet<TObjectKey<AActor>> IgnoredActorSet;
+
 private:
 	// Functions that are bound to the OnComponentBeginOverlap and OnComponentEndOverlap delegates of the capsules.
 	UFUNCTION()
@@ -0,0 +1,117 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Items/Weapons/Weapon.h"
+#include "ChaosMusket.generated.h"
+
+/**
+ * The Chaos Dwarf Musket: a hitscan weapon that fires a blast of pellets.
+ * All pellets of a shot are generated together, four at a time with vector math: their directions in the spread
+ * cone and the points of their ballistic arcs. Every segment of every arc is then submitted as an asynchronous line
+ * trace in one go, so the physics scene traces the whole blast in parallel with the rest of the frame. The results
+ * are collected on the next frame; each pellet stops at the first segment that hits something, and the pellets that
+ * hit the same target are added up and queued on the UChaosDamageSubsystem as a single hit.
+ * The melee hit detection inherited from AWeapon keeps working, e.g. for a bayonet.
+ */
+UCLASS()
+class CHAOSRIFTS_API AChaosMusket : public AWeapon
+{
+	GENERATED_BODY()
+
+public:
+	AChaosMusket();
+
+	//~ Begin AActor Interface
+	virtual void Tick(float DeltaTime) override;
+	//~ End AActor Interface
+
+	/**
+	 * Fires a shot from the muzzle.
+	 * @param AimDirection Where the shot is aimed. The pellets spread around it. Does not need to be normalized.
+	 * @return False if the musket is still reloading.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Musket")
+	bool Fire(const FVector& AimDirection);
+
+	/** Returns true if the musket can fire again. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Musket")
+	bool IsReadyToFire() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	//~ Begin AWeapon Interface
+	virtual bool WantsTick() const override;
+	//~ End AWeapon Interface
+
+	// The number of pellets in a shot. Each pellet deals the weapon's Damage.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "1", ClampMax = "64"))
+	int32 PelletCount = 8;
+
+	// The angle between the aim direction and the edge of the spread cone, in degrees.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "0.0", ClampMax = "45.0"))
+	float SpreadAngle = 6.f;
+
+	// How far each pellet may randomly deviate from its place in the spread pattern, as a fraction of SpreadAngle.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SpreadJitter = 0.25f;
+
+	// The speed of the pellets leaving the muzzle, in cm/s. Together with gravity it decides how much they drop.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "1.0"))
+	float MuzzleVelocity = 20000.f;
+
+	// How strongly world gravity pulls the pellets down. 0 traces straight lines.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "0.0"))
+	float PelletGravityScale = 1.f;
+
+	// How far a pellet flies before it is discarded. Its arc is traced for MaxRange / MuzzleVelocity seconds of flight.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "0.0"))
+	float MaxRange = 4000.f;
+
+	// The number of line segments each pellet's arc is traced as. Only used while the pellets drop.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 BallisticSegments = 3;
+
+	// Seconds between two shots.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket", meta = (ClampMin = "0.0"))
+	float ReloadTime = 1.5f;
+
+	// The socket on the weapon mesh the pellets leave from. Falls back to the actor location.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Musket")
+	FName MuzzleSocketName = TEXT("Muzzle");
+
+private:
+	/** A fired shot whose traces are in flight. */
+	struct FPendingShot
+	{
+		/** The engine frame the shot was fired in. Its results are available from the next frame on. */
+		uint64 FrameNumber = 0;
+
+		/** The number of trace segments per pellet. */
+		int32 NumSegments = 0;
+
+		/** The traces of all pellets, pellet-major: pellet P, segment S is at P * NumSegments + S. */
+		TArray<FTraceHandle> Handles;
+
+		TWeakObjectPtr<AController> Instigator;
+	};
+
+	/** Collects the results of the shots fired before this frame and queues their damage. */
+	void ResolvePendingShots();
+
+	/** Shots waiting for their results. */
+	TArray<FPendingShot> PendingShots;
+
+	/** The world time of the last shot. */
+	double LastFireTime = -UE_BIG_NUMBER;
+
+	/** Random source for the spread of each shot. */
+	FRandomStream SpreadStream;
+
+	//~ Scratch buffers reused by every shot, so firing does not allocate once they have grown.
+	TArray<float> PelletJitters;
+	TArray<FVector> PelletPathPoints;
+};
@@ -0,0 +1,131 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/StaticMeshComponent.h"
+#include "Items/Weapons/Weapon.h"
+#include "Items/Weapons/WeaponHitTracking.h"
+#include "ChaosWeaponComponent.generated.h"
+
+/**
+ * A weapon that lives as a component on the character wielding it instead of as an AWeapon actor of its own.
+ * It takes its mesh, collision and combat settings from the defaults of an AWeapon class and detects and deals
+ * hits the same way, so the same weapon Blueprints serve both representations.
+ * @see AChaosCharacterBase::bUseWeaponComponents
+ */
+UCLASS(ClassGroup = (Chaos), meta = (BlueprintSpawnableComponent))
+class CHAOSRIFTS_API UChaosWeaponComponent : public UStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UChaosWeaponComponent();
+
+	/** Takes over the mesh, collision and combat settings of a weapon class. Call before registering the component. */
+	void InitializeFromWeaponClass(TSubclassOf<AWeapon> InWeaponClass);
+
+	/** Returns the weapon class this component was initialized from. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon")
+	TSubclassOf<AWeapon> GetWeaponClass() const { return WeaponClass; }
+
+	/**
+	 * Sets the state of the weapon.
+	 * @param NewState The new state (Passive or Aggressive).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|State")
+	void SetWeaponState(EWeaponState NewState);
+
+	/** Returns the current state of the weapon. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|State")
+	EWeaponState GetWeaponState() const { return CurrentWeaponState; }
+
+	/** Sets the damage this weapon causes per hit. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Combat")
+	void SetDamage(float NewDamage) { Damage = NewDamage; }
+
+	/** Replaces the actor classes this weapon ignores and recompiles their lookup. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Combat")
+	void SetIgnoredActorClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredActorClasses);
+
+	/** Replaces the actor instances this weapon ignores and recompiles their lookup. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Combat")
+	void SetIgnoredActors(const TArray<AActor*>& NewIgnoredActors);
+
+	/** Returns the ID of the current (or last) aggressive window. Increases by one for every swing. */
+	uint32 GetCurrentSwingId() const { return SwingTracker.GetCurrentSwingId(); }
+
+	//~ Begin UActorComponent Interface
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	//~ End UActorComponent Interface
+
+protected:
+	//~ Begin UActorComponent Interface
+	virtual void BeginPlay() override;
+	//~ End UActorComponent Interface
+
+	// The damage this weapon causes per hit. Set it at runtime through SetDamage().
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Combat")
+	float Damage = 25.f;
+
+	// A list of specific actor classes to ignore during collision checks.
+	// Compiled at BeginPlay; set it at runtime through SetIgnoredActorClasses().
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Combat")
+	TArray<TSubclassOf<AActor>> IgnoredActorClasses;
+
+	// A list of specific actor instances to ignore during collision checks, like AItem's.
+	// Compiled at BeginPlay; set it at runtime through SetIgnoredActors().
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Combat", meta = (DisplayName = "Ignored Actor Instances"))
+	TArray<TObjectPtr<AActor>> IgnoredActors;
+
+	// How this weapon detects hits while Aggressive.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection")
+	EWeaponHitDetectionMode HitDetectionMode = EWeaponHitDetectionMode::Overlap;
+
+	// Sockets on the weapon mesh that are swept in Sweep mode. If empty, the origin of the mesh is swept.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	TArray<FName> TraceSocketNames;
+
+	// Radius of the sphere swept along each trace socket.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (ClampMin = "0.0", EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	float TraceRadius = 10.f;
+
+	// Additional interpolated poses swept per frame.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (ClampMin = "0", ClampMax = "8", EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	int32 SweepSubsteps = 0;
+
+	// The object type that is considered a potential target by the sweeps.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	TEnumAsByte<ECollisionChannel> TraceObjectType = ECC_Pawn;
+
+private:
+	// The current state of the weapon. Passive by default.
+	UPROPERTY(VisibleAnywhere, Category = "Weapon|State")
+	EWeaponState CurrentWeaponState = EWeaponState::Passive;
+
+	// The weapon class the settings were taken from.
+	UPROPERTY()
+	TSubclassOf<AWeapon> WeaponClass;
+
+	// Called when the weapon mesh begins to overlap with another actor.
+	UFUNCTION()
+	void OnWeaponBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	// Runs the ignore checks for an actor touched by the weapon and queues damage if it passes them.
+	void TryDamageActor(AActor* OtherActor);
+
+	// Compiles IgnoredActors and IgnoredActorClasses into their lookups.
+	void RebuildIgnoreFilters();
+
+	// The trace sockets and the pose of the last sweep.
+	FChaosWeaponSweep WeaponSweep;
+
+	// Stamps every damaged actor with the ID of the swing that hit it.
+	FChaosSwingTracker SwingTracker;
+
+	// IgnoredActorClasses compiled into a constant-time class lookup.
+	FChaosActorClassFilter IgnoredClassFilter;
+
+	// IgnoredActors compiled into a set.
+	TSet<TObjectKey<AActor>> IgnoredActorSet;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Items/Item.h"
+#include "Items/Weapons/WeaponHitTracking.h"
 #include "Weapon.generated.h"
 
 UENUM(BlueprintType)
@@ -15,6 +16,16 @@ enum class EWeaponState : uint8
 	Aggressive 
 };
 
+UENUM(BlueprintType)
+enum class EWeaponHitDetectionMode : uint8
+{
+	// Hits are detected through the overlap events of the weapon mesh.
+	Overlap,
+	// Hits are detected by sweeping the trace sockets between the last and the current pose while Aggressive.
+	// Overlap events on the weapon mesh are disabled in this mode.
+	Sweep
+};
+
 /**
  * AWeapon is a special type of AItem that can cause damage.
  * It has states to control when it actively deals damage.
@@ -25,9 +36,16 @@ class CHAOSRIFTS_API AWeapon : public AItem
 {
 	GENERATED_BODY()
 
+	// Weapon components take their settings from the defaults of a weapon class.
+	friend class UChaosWeaponComponent;
+
 public:
 	AWeapon();
 
+	//~ Begin AActor Interface
+	virtual void Tick(float DeltaTime) override;
+	//~ End AActor Interface
+
 	/**
 	 * Sets the state of the weapon.
 	 * @param NewState The new state (Passive or Aggressive).
@@ -39,9 +57,32 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Weapon|State")
 	EWeaponState GetWeaponState() const { return CurrentWeaponState; }
 
+	/** Returns the ID of the current (or last) aggressive window. Increases by one for every swing. */
+	uint32 GetCurrentSwingId() const { return SwingTracker.GetCurrentSwingId(); }
+
+	//~ Begin AItem Interface
+	virtual void RebuildIgnoreFilters() override;
+	//~ End AItem Interface
+
+	/** Replaces the actor classes this weapon ignores and recompiles their lookup. */
+	UFUNCTION(BlueprintCallable, Category = "Weapon|Combat")
+	void SetIgnoredActorClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredActorClasses);
+
 protected:
 	virtual void BeginPlay() override;
 
+	/**
+	 * Returns true while the weapon has work to do in Tick. AWeapon only ticks for sweeps while Aggressive;
+	 * subclasses with work of their own extend this, and must call UpdateTickEnabled() when that work starts or ends.
+	 */
+	virtual bool WantsTick() const;
+
+	/** Enables ticking exactly while WantsTick() is true. */
+	void UpdateTickEnabled();
+
+	/** Returns true if this weapon must not damage an actor (an ignored instance or an instance of an ignored class). */
+	bool IsIgnoredTarget(const AActor* OtherActor) const;
+
 	// The damage this weapon causes per hit.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon|Combat")
 	float Damage;
@@ -49,9 +90,31 @@ protected:
 	// NOTE: bIgnoreOwner is now inherited from the AItem base class.
 	
 	// A list of specific actor classes to ignore during collision checks.
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon|Combat")
+	// Compiled at BeginPlay; set it at runtime through SetIgnoredActorClasses().
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Combat")
     TArray<TSubclassOf<AActor>> IgnoredActorClasses;
 
+	// How this weapon detects hits while Aggressive.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection")
+	EWeaponHitDetectionMode HitDetectionMode = EWeaponHitDetectionMode::Overlap;
+
+	// Sockets on the weapon mesh that are swept in Sweep mode (e.g. hilt, middle and tip of a blade).
+	// If empty, the origin of the weapon mesh is swept.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	TArray<FName> TraceSocketNames;
+
+	// Radius of the sphere swept along each trace socket.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (ClampMin = "0.0", EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	float TraceRadius = 10.f;
+
+	// Additional interpolated poses swept per frame. Raise this for weapons with wide, fast arcs.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (ClampMin = "0", ClampMax = "8", EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	int32 SweepSubsteps = 0;
+
+	// The object type that is considered a potential target by the sweeps.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon|Hit Detection", meta = (EditCondition = "HitDetectionMode == EWeaponHitDetectionMode::Sweep"))
+	TEnumAsByte<ECollisionChannel> TraceObjectType = ECC_Pawn;
+
 private:
 	// The current state of the weapon. Passive by default.
 	UPROPERTY(VisibleAnywhere, Category = "Weapon|State")
@@ -61,8 +124,19 @@ private:
 	UFUNCTION()
 	void OnMeshBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
-	// A list of actors that have already received damage in this "attack swing"
+	// Runs the ignore checks for an actor touched by the weapon and queues damage if it passes them.
+	void TryDamageActor(AActor* OtherActor);
+
+	// Sweeps every trace socket from the previous to the current pose of the weapon mesh.
+	void SweepTraceSockets();
+
+	// The trace sockets and the pose of the last sweep.
+	FChaosWeaponSweep WeaponSweep;
+
+	// Stamps every damaged actor with the ID of the swing that hit it,
 	// to prevent them from being hit multiple times per attack.
-	UPROPERTY()
-	TArray<TObjectPtr<AActor>> DamagedActorsInSwing;
+	FChaosSwingTracker SwingTracker;
+
+	// IgnoredActorClasses compiled into a constant-time class lookup.
+	FChaosActorClassFilter IgnoredClassFilter;
 };
@@ -0,0 +1,85 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/HitResult.h"
+#include "UObject/ObjectKey.h"
+#include "Templates/SubclassOf.h"
+
+class AActor;
+class USceneComponent;
+
+/**
+ * Tracks which actors a weapon has already hit during the current swing.
+ * Every swing gets a new, monotonically increasing ID and each hit target is stamped with the ID of the
+ * swing that last hit it. Starting a new swing therefore invalidates all stamps without touching them.
+ */
+struct CHAOSRIFTS_API FChaosSwingTracker
+{
+	/** Starts a new swing. Targets hit in earlier swings can be hit again. */
+	void BeginSwing();
+
+	/**
+	 * Stamps the target with the current swing ID.
+	 * @return False if the target was already hit during the current swing.
+	 */
+	bool TryMarkHit(const AActor* Target);
+
+	/** Returns the ID of the current swing. 0 means no swing has started yet. */
+	uint32 GetCurrentSwingId() const { return CurrentSwingId; }
+
+private:
+	/** The ID of the swing that last hit each target. */
+	TMap<TObjectKey<AActor>, uint32> LastHitSwing;
+
+	uint32 CurrentSwingId = 0;
+};
+
+/**
+ * A list of ignored actor classes compiled into a lookup table.
+ * The result for each concrete class is computed once with IsChildOf and cached, so every
+ * further check for an actor of that class is a single hash lookup.
+ */
+struct CHAOSRIFTS_API FChaosActorClassFilter
+{
+	/** Rebuilds the filter from a list of classes. Subclasses of these classes are ignored as well. */
+	void Compile(TConstArrayView<TSubclassOf<AActor>> InIgnoredClasses);
+
+	/** Returns true if the actor is an instance of one of the ignored classes. */
+	bool IsIgnored(const AActor* Actor) const;
+
+private:
+	TArray<TObjectKey<UClass>> IgnoredClasses;
+
+	/** Cached results per concrete class. Filled lazily, as the set of classes we meet is small. */
+	mutable TMap<TObjectKey<UClass>, bool> ClassResults;
+};
+
+/**
+ * The sweep hit detection shared by AWeapon and UChaosWeaponComponent.
+ * Sweeps a set of points on the weapon mesh from its pose at the last sweep to the current one, through optional
+ * interpolated poses, so fast swings cannot tunnel through a target regardless of the frame rate.
+ */
+struct CHAOSRIFTS_API FChaosWeaponSweep
+{
+	/** Resolves the trace sockets once; they are constant relative to the mesh. Without any, the mesh origin is swept. */
+	void ResolveTracePoints(const USceneComponent* Mesh, TConstArrayView<FName> SocketNames);
+
+	/** Makes the next sweep start at the current pose of the mesh, e.g. when a swing begins. */
+	void BeginSweeping(const USceneComponent* Mesh);
+
+	/** Sweeps the trace points up to the current pose of the mesh and reports every actor they touched. */
+	void Sweep(const USceneComponent* Mesh, float Radius, int32 Substeps, ECollisionChannel ObjectType, const FCollisionQueryParams& QueryParams, TFunctionRef<void(AActor*)> OnHitActor);
+
+private:
+	/** The trace points relative to the mesh. */
+	TArray<FVector> TracePointLocations;
+
+	/** The transform of the mesh at the end of the last sweep. */
+	FTransform PreviousMeshTransform;
+
+	/** Reused hit buffer for the sweeps. */
+	TArray<FHitResult> SweepHits;
+};
@@ -0,0 +1,48 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ChaosBakeLedgesCommandlet.generated.h"
+
+struct FChaosLedgeSegment;
+
+/**
+ * Bakes the mantleable ledges of levels into an AChaosLedgeIndex saved with each level.
+ * Ledges are the horizontal edges of static, WorldStatic-blocking meshes where a walkable top meets a wall, at least
+ * MinMantleHeight above the ground in front of them and with room for the player's capsule on top. The landing
+ * check is the one the runtime mantle probe makes; the drop check is bake-only and filters out mere steps.
+ * The mantle settings and capsule size are read from the player character class.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd ChaosRifts.uproject -run=ChaosBakeLedges -Maps=/Game/Maps/Arena+/Game/Rooms/Room_A
+ *     [-Character=/Game/Characters/BP_Player.BP_Player_C] [-CellSize=400] [-SegmentLength=100]
+ */
+UCLASS()
+class UChaosBakeLedgesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UChaosBakeLedgesCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+
+private:
+#if WITH_EDITOR
+	/** Loads a map, bakes its ledges and saves it. */
+	bool BakeMap(const FString& PackageName) const;
+
+	/** Extracts and validates the ledges of all static meshes in a world. */
+	void CollectLedges(UWorld* World, TArray<FChaosLedgeSegment>& OutSegments) const;
+#endif
+
+	float CellSize = 400.f;
+	float SegmentLength = 100.f;
+	float MinMantleHeight = 50.f;
+	float CapsuleRadius = 42.f;
+	float CapsuleHalfHeight = 96.f;
+};
@@ -0,0 +1,135 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ChaosLedgeIndex.generated.h"
+
+/** The mantle geometry shared by the runtime probe and the ledge bake, so both test the same landing spot. */
+namespace ChaosLedges
+{
+	/** How far past the wall a mantle grabs the top of a ledge. */
+	inline constexpr float LedgeInset = 15.f;
+
+	/** Returns the point on top of a ledge a mantle grabs, given a point on its edge and the direction into it. */
+	inline FVector GetLedgePoint(const FVector& EdgePoint, const FVector& IntoLedge)
+	{
+		return EdgePoint + IntoLedge * LedgeInset;
+	}
+
+	/** Returns where a capsule stands after mantling onto a ledge point. */
+	inline FVector GetLandingLocation(const FVector& LedgePoint, const FVector& IntoLedge, float CapsuleRadius, float CapsuleHalfHeight)
+	{
+		return LedgePoint + IntoLedge * CapsuleRadius * 1.5f + FVector(0.f, 0.f, CapsuleHalfHeight + 5.f);
+	}
+}
+
+/** A straight, mantleable ledge edge. */
+USTRUCT()
+struct FChaosLedgeSegment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector End = FVector::ZeroVector;
+
+	/** The horizontal normal of the wall below the ledge, pointing away from the wall. */
+	UPROPERTY()
+	FVector Normal = FVector::ForwardVector;
+};
+
+/** The ledge segments touching one grid cell, as a range of AChaosLedgeIndex::CellSegments. */
+USTRUCT()
+struct FChaosLedgeCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FIntPoint Coord = FIntPoint::ZeroValue;
+
+	UPROPERTY()
+	int32 FirstIndex = 0;
+
+	UPROPERTY()
+	int32 NumIndices = 0;
+};
+
+/** A ledge found by a query. */
+struct FChaosLedgeHit
+{
+	/** Where the query ray meets the ledge edge. */
+	FVector Point = FVector::ZeroVector;
+
+	/** The horizontal normal of the wall below the ledge, pointing away from the wall. */
+	FVector Normal = FVector::ForwardVector;
+
+	/** The horizontal distance from the query origin to Point. */
+	float Distance = 0.f;
+};
+
+/**
+ * Pre-baked mantleable ledges of one level, stored as a sparse 2D grid.
+ * The actor is created and filled by the ChaosBakeLedges commandlet and saved with its level, so every level and
+ * procedurally placed room brings its own ledges. Ledges are stored relative to the actor and follow its transform.
+ * At runtime the actor registers with the UChaosLedgeSubsystem, which answers the player's mantle queries from
+ * these cells before any world trace is made. Geometry the bake cannot see (BSP, landscapes, movable meshes) is not
+ * in the index, so a query that finds nothing here still has to fall back to tracing.
+ * Cells are sorted by coordinate and point into a shared index array, so a lookup is a binary search plus a short
+ * loop over the few segments of the cell.
+ */
+UCLASS(NotBlueprintable, HideCategories = (Rendering, Physics, Collision, Input, Actor, LOD, Cooking))
+class CHAOSRIFTS_API AChaosLedgeIndex : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AChaosLedgeIndex();
+
+	/**
+	 * Replaces the baked ledges and rebuilds the grid.
+	 * @param InSegments The ledges to store.
+	 * @param InCellSize The edge length of a grid cell.
+	 */
+	void SetLedges(TArray<FChaosLedgeSegment>&& InSegments, float InCellSize);
+
+	/**
+	 * Finds the closest ledge a horizontal ray from Origin along Direction (both in world space) crosses within
+	 * MaxDistance, with the ledge between MinHeight and MaxHeight above Origin and its wall facing the ray.
+	 * @return Whether a ledge was found.
+	 */
+	bool FindLedge(const FVector& Origin, const FVector& Direction, float MaxDistance, float MinHeight, float MaxHeight, FChaosLedgeHit& OutHit) const;
+
+	/** Returns the number of baked ledge segments. */
+	int32 GetNumSegments() const { return Segments.Num(); }
+
+protected:
+	//~ Begin AActor Interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
+private:
+	/** Returns the grid cell containing a location. */
+	FIntPoint GetCellCoord(const FVector& Location) const;
+
+	/** Returns the cell at a coordinate, or null if it holds no ledges. */
+	const FChaosLedgeCell* FindCell(const FIntPoint& Coord) const;
+
+	UPROPERTY(VisibleAnywhere, Category = "Ledges")
+	TArray<FChaosLedgeSegment> Segments;
+
+	/** The non-empty cells, sorted by Coord (Y first, then X). */
+	UPROPERTY()
+	TArray<FChaosLedgeCell> Cells;
+
+	/** The segment indices of all cells, back to back. */
+	UPROPERTY()
+	TArray<int32> CellSegments;
+
+	UPROPERTY(VisibleAnywhere, Category = "Ledges")
+	float CellSize = 400.f;
+};
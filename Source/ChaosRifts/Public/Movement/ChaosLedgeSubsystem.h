@@ -0,0 +1,35 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Movement/ChaosLedgeIndex.h"
+#include "ChaosLedgeSubsystem.generated.h"
+
+/**
+ * Answers mantle queries from the baked ledges of all loaded levels and rooms.
+ * Each AChaosLedgeIndex registers itself while it is in play. A found ledge is ready to mantle; when no baked ledge
+ * is found, callers fall back to tracing the world, since only static meshes are baked.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosLedgeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Makes a level's baked ledges available to queries. */
+	void RegisterLedgeIndex(AChaosLedgeIndex* LedgeIndex);
+
+	/** Removes a level's baked ledges, e.g. when its room is unloaded. */
+	void UnregisterLedgeIndex(AChaosLedgeIndex* LedgeIndex);
+
+	/**
+	 * Finds the closest baked ledge in front of a character.
+	 * @see AChaosLedgeIndex::FindLedge
+	 */
+	bool FindLedge(const FVector& Origin, const FVector& Direction, float MaxDistance, float MinHeight, float MaxHeight, FChaosLedgeHit& OutHit) const;
+
+private:
+	TArray<TWeakObjectPtr<AChaosLedgeIndex>> LedgeIndices;
+};
@@ -0,0 +1,90 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "ChaosHealthBarSubsystem.generated.h"
+
+class AChaosEnemy;
+class APlayerController;
+class UChaosHealthBarWidget;
+
+/**
+ * Draws enemy health bars from a small, fixed pool of widgets instead of one widget component per enemy.
+ * Enemies request a health bar while they are hurt. Every frame the requesting enemies are projected to the
+ * screen in one pass with a single view-projection matrix, and the pool is handed to the closest on-screen ones.
+ * Widgets stay with their enemy for as long as it remains among the closest, so bars do not jump around.
+ * The pass runs after the world has updated its cameras, so the bars are projected with this frame's view.
+ * The pool belongs to the first local player that set it up; split-screen is not supported.
+ */
+UCLASS()
+class CHAOSRIFTS_API UChaosHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Creates the widget pool for a local player.
+	 * @param InOwningController The player whose viewport the health bars are drawn into.
+	 * @param WidgetClass The health bar widget to pool.
+	 * @param PoolSize The maximum number of health bars shown at the same time.
+	 * @param InMaxDistance Enemies farther away from the camera get no health bar.
+	 * @param InWorldOffset Offset from the enemy's location to where its health bar is drawn.
+	 */
+	void SetupHealthBars(APlayerController* InOwningController, TSubclassOf<UChaosHealthBarWidget> WidgetClass, int32 PoolSize, float InMaxDistance, const FVector& InWorldOffset);
+
+	/** Adds or removes an enemy from the enemies competing for a health bar. */
+	void SetHealthBarRequested(AChaosEnemy* Enemy, bool bRequested);
+
+	/** Pushes an enemy's new health to its widget, if it currently has one. */
+	void NotifyHealthChanged(AChaosEnemy* Enemy);
+
+	/** Returns how many health bars are currently shown. */
+	int32 GetNumShownHealthBars() const;
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	struct FCandidate
+	{
+		AChaosEnemy* Enemy = nullptr;
+		FVector2D ScreenPosition = FVector2D::ZeroVector;
+		double DistanceSquared = 0.0;
+	};
+
+	/** Bound to FWorldDelegates::OnWorldPostActorTick, which the world broadcasts after updating the cameras. */
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Projects the requesting enemies and hands the widgets to the closest on-screen ones. */
+	void UpdateHealthBars();
+
+	/** Releases a pooled widget and hides it. */
+	void ReleaseWidget(UChaosHealthBarWidget* Widget);
+
+	/** The pooled widgets. Their count never changes after setup. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UChaosHealthBarWidget>> WidgetPool;
+
+	/** The enemies currently requesting a health bar. */
+	TArray<TWeakObjectPtr<AChaosEnemy>> RequestingEnemies;
+
+	/** Scratch buffer for the on-screen candidates of this frame. */
+	TArray<FCandidate> Candidates;
+
+	TWeakObjectPtr<APlayerController> OwningController;
+	float MaxDistance = 0.f;
+	FVector WorldOffset = FVector::ZeroVector;
+
+	FDelegateHandle PostActorTickHandle;
+};
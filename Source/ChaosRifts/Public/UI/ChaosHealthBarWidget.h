@@ -0,0 +1,42 @@
+// Copyright Robinator Studios, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ChaosHealthBarWidget.generated.h"
+
+class AChaosEnemy;
+
+/**
+ * Base class for the enemy health bar widgets handed out by UChaosHealthBarSubsystem.
+ * The widgets are pooled: the same instance is shown above different enemies over time. Blueprint subclasses
+ * only draw the bar and react to the events below; they never have to poll the enemy.
+ */
+UCLASS(Abstract)
+class CHAOSRIFTS_API UChaosHealthBarWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Assigns the enemy this widget currently shows the health of. Null releases the widget back to the pool. */
+	void SetTargetEnemy(AChaosEnemy* NewTargetEnemy);
+
+	/** Pushes the current health of the target enemy to the widget. */
+	void RefreshHealth();
+
+	UFUNCTION(BlueprintCallable, Category = "Chaos|UI")
+	AChaosEnemy* GetTargetEnemy() const { return TargetEnemy.Get(); }
+
+protected:
+	/** Called when the widget is assigned to another enemy (or released, with null). */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Chaos|UI")
+	void OnTargetEnemyChanged(AChaosEnemy* NewTargetEnemy);
+
+	/** Called when the widget gets a new target and whenever the target's health changed. */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Chaos|UI")
+	void OnHealthChanged(float Health, float MaxHealth);
+
+private:
+	TWeakObjectPtr<AChaosEnemy> TargetEnemy;
+};